@@ -0,0 +1,164 @@
+// Tests AsyncSignal and its awaiter, which NextReport, WhenReady and NextDeviceChange in Awaitables.h wrap, along
+// with RunLoop as the executor. The awaiter is driven by hand through await_ready, await_suspend and await_resume,
+// with a stand-in for a coroutine handle, so this builds as C++17.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP AsyncSignalTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP AsyncSignalTest.cpp -o AsyncSignalTest
+//
+// Usage: AsyncSignalTest
+
+#include <atomic>
+#include <thread>
+#include "Check.h"
+#include "WGIC/AsyncSignal.h"
+
+using namespace winrt::WGIC::Core;
+
+// Stands in for a coroutine handle, recording how often and on which thread it was resumed
+struct FakeHandle
+{
+    std::atomic<int>* Resumed;
+    std::thread::id* ResumedOn;
+
+    void resume()
+    {
+        *ResumedOn = std::this_thread::get_id();
+        (*Resumed)++;
+    }
+};
+
+static void TestNotifyBeforeSuspend()
+{
+    AsyncSignal signal;
+    std::atomic<int> resumed { 0 };
+    std::thread::id resumedOn;
+
+    auto awaiter = signal.Next();
+    CHECK(!awaiter.await_ready());
+
+    // Lands after the coroutine decided to suspend, but before it registered
+    signal.Notify();
+    CHECK(!awaiter.await_suspend(FakeHandle { &resumed, &resumedOn }));
+    CHECK(awaiter.await_resume() == 1);
+
+    // Not registered, so a later Notify mustn't resume it a second time
+    signal.Notify();
+    CHECK(resumed == 0);
+}
+
+static void TestAlreadySignalled()
+{
+    AsyncSignal signal;
+    signal.Notify();
+
+    // WhenReady waits for a count past 0, so a device that's already ready doesn't suspend at all
+    AsyncSignal::Awaiter awaiter(signal, 0, {});
+    CHECK(awaiter.await_ready());
+    CHECK(awaiter.await_resume() == 1);
+}
+
+static void TestSeveralWaiters()
+{
+    AsyncSignal signal;
+    std::atomic<int> resumed { 0 };
+    std::thread::id resumedOn;
+
+    AsyncSignal::Awaiter awaiters[] = { signal.Next(), signal.Next(), signal.Next() };
+    for (auto& awaiter : awaiters)
+    {
+        CHECK(!awaiter.await_ready());
+        CHECK(awaiter.await_suspend(FakeHandle { &resumed, &resumedOn }));
+    }
+    CHECK(resumed == 0);
+
+    signal.Notify();
+    CHECK(resumed == 3);
+    for (auto& awaiter : awaiters)
+        CHECK(awaiter.await_resume() == 1);
+
+    // Each wait is for one occurrence only
+    signal.Notify();
+    CHECK(resumed == 3);
+}
+
+static void TestInlineResumption()
+{
+    AsyncSignal signal;
+    std::atomic<int> resumed { 0 };
+    std::thread::id resumedOn;
+
+    auto awaiter = signal.Next();
+    CHECK(awaiter.await_suspend(FakeHandle { &resumed, &resumedOn }));
+
+    // Without an executor, the waiter runs on whichever thread notifies
+    std::thread::id notifier;
+    std::thread([&]
+    {
+        notifier = std::this_thread::get_id();
+        signal.Notify();
+    }).join();
+
+    CHECK(resumed == 1);
+    CHECK(resumedOn == notifier);
+}
+
+static void TestExecutorResumption()
+{
+    AsyncSignal signal;
+    RunLoop loop;
+    std::atomic<int> resumed { 0 };
+    std::thread::id resumedOn;
+
+    AsyncSignal::Awaiter awaiters[] = { signal.Next(loop.GetExecutor()), signal.Next(loop.GetExecutor()) };
+    for (auto& awaiter : awaiters)
+        CHECK(awaiter.await_suspend(FakeHandle { &resumed, &resumedOn }));
+
+    // Notifying only queues the continuations, which then run on the thread servicing the loop
+    std::thread([&] { signal.Notify(); }).join();
+    CHECK(resumed == 0);
+    CHECK(loop.RunPending() == 2);
+    CHECK(resumed == 2);
+    CHECK(resumedOn == std::this_thread::get_id());
+    CHECK(loop.RunPending() == 0);
+}
+
+static void TestRunLoopThread()
+{
+    AsyncSignal signal;
+    RunLoop loop;
+    std::thread::id ranOn;
+
+    // One thread servicing a run of waits, each registered from the continuation of the last
+    std::atomic<int> remaining { 5 };
+    std::function<void()> waitAgain = [&]
+    {
+        ranOn = std::this_thread::get_id();
+        if (--remaining > 0)
+            signal.Wait(signal.Count(), loop.GetExecutor(), waitAgain);
+        else
+            loop.Stop();
+    };
+    CHECK(signal.Wait(0, loop.GetExecutor(), waitAgain));
+
+    std::thread servicer([&] { loop.Run(); });
+    std::thread::id servicerId = servicer.get_id();
+    while (remaining > 0)
+    {
+        signal.Notify();
+        std::this_thread::yield();
+    }
+    servicer.join();
+
+    CHECK(remaining == 0);
+    CHECK(ranOn == servicerId);
+}
+
+int main()
+{
+    TestNotifyBeforeSuspend();
+    TestAlreadySignalled();
+    TestSeveralWaiters();
+    TestInlineResumption();
+    TestExecutorResumption();
+    TestRunLoopThread();
+    return CheckResult("AsyncSignalTest");
+}
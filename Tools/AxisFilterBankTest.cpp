@@ -0,0 +1,176 @@
+// Checks that the SSE2 and portable versions of AxisFilterBank give the same results, and with --bench measures both
+// on every lane: 16 device slots of 8 axes.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP AxisFilterBankTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP AxisFilterBankTest.cpp -o AxisFilterBankTest
+//
+// Usage: AxisFilterBankTest [--bench]
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include "Check.h"
+#include "WGIC/AxisFilterBank.h"
+
+using namespace winrt::WGIC::Core;
+
+using RawAxes = int32_t[MaxDeviceSlots][AxesPerDevice];
+using FilteredAxes = float[MaxDeviceSlots][AxesPerDevice];
+
+// A different mix of deadzones, curves and smoothing on every axis
+static void ConfigureVaried(AxisFilterBank& bank)
+{
+    for (size_t slot = 0; slot < MaxDeviceSlots; slot++)
+    {
+        for (size_t axis = 0; axis < AxesPerDevice; axis++)
+        {
+            size_t variant = slot * AxesPerDevice + axis;
+            AxisFilterSettings settings {};
+            settings.Center = variant % 2 ? 0 : 32768;
+            settings.Scale = 1.0f / 32767.0f;
+            settings.InnerDeadzone = 0.05f * (variant % 4);
+            settings.OuterDeadzone = 1.0f - 0.02f * (variant % 3);
+            settings.RadialDeadzone = (variant / 2) % 2 == 0;
+            settings.CurveCubic = 0.25f * (variant % 5);
+            settings.Smoothing = static_cast<AxisSmoothing>(variant % 3);
+            settings.SmoothingFactor = 0.3f;
+            settings.MinCutoff = 1.0f;
+            settings.Beta = 0.01f * (variant % 7);
+            settings.DerivativeCutoff = 1.0f;
+            bank.Configure(slot, axis, settings);
+        }
+    }
+}
+
+// Sticks wandering around their range, with centered and full-deflection spells
+static void NextFrame(std::mt19937& random, RawAxes& raw)
+{
+    for (size_t slot = 0; slot < MaxDeviceSlots; slot++)
+    {
+        for (size_t axis = 0; axis < AxesPerDevice; axis++)
+        {
+            int32_t center = (slot * AxesPerDevice + axis) % 2 ? 0 : 32768;
+            int32_t value = raw[slot][axis] + static_cast<int32_t>(random() % 4001) - 2000;
+            if (random() % 50 == 0)
+                value = center;
+            if (random() % 50 == 0)
+                value = center + (random() % 2 ? 40000 : -40000);
+            raw[slot][axis] = value;
+        }
+    }
+}
+
+static void TestEquivalence()
+{
+#ifdef WGIC_AXIS_FILTER_SSE2
+    static AxisFilterBank scalar;
+    static AxisFilterBank sse2;
+    ConfigureVaried(scalar);
+    ConfigureVaried(sse2);
+
+    std::mt19937 random(1);
+    RawAxes raw {};
+    FilteredAxes scalarOutput, sse2Output;
+    float worst = 0;
+    for (int frame = 0; frame < 10000; frame++)
+    {
+        NextFrame(random, raw);
+        float deltaTime = frame % 100 == 0 ? 0.05f : 0.001f + 0.0001f * (random() % 20);
+        if (frame == 5000)
+        {
+            scalar.Reset(3);
+            sse2.Reset(3);
+        }
+
+        scalar.ProcessScalar(raw, scalarOutput, deltaTime);
+        sse2.ProcessSse2(raw, sse2Output, deltaTime);
+        for (size_t slot = 0; slot < MaxDeviceSlots; slot++)
+        {
+            for (size_t axis = 0; axis < AxesPerDevice; axis++)
+                worst = std::fmax(worst, std::fabs(scalarOutput[slot][axis] - sse2Output[slot][axis]));
+        }
+    }
+
+    printf("Largest difference between SSE2 and portable output: %g\n", worst);
+    CHECK(worst < 1e-4f);
+#else
+    printf("SSE2 isn't available, only the portable version was checked\n");
+#endif
+}
+
+// Values that are easy to work out by hand, through the portable version
+static void TestKnownValues()
+{
+    static AxisFilterBank bank;
+    AxisFilterSettings settings {};
+    settings.Scale = 0.001f;
+    settings.InnerDeadzone = 0.2f;
+    settings.OuterDeadzone = 0.8f;
+    settings.Smoothing = AxisSmoothing::Exponential;
+    settings.SmoothingFactor = 0.5f;
+    bank.Configure(0, 0, settings);
+
+    RawAxes raw {};
+    FilteredAxes output;
+    raw[0][0] = 100; // 0.1, inside the deadzone
+    bank.Process(raw, output, 0.001f);
+    CHECK(output[0][0] == 0);
+
+    raw[0][0] = 500; // 0.5, halfway between the deadzones; the first value isn't smoothed
+    bank.Process(raw, output, 0.001f);
+    CHECK(std::fabs(output[0][0] - 0.25f) < 1e-5f);
+
+    raw[0][0] = 900; // Past the outer deadzone
+    bank.Process(raw, output, 0.001f);
+    CHECK(std::fabs(output[0][0] - 0.625f) < 1e-5f);
+
+    bank.Reset(0);
+    raw[0][0] = -900;
+    bank.Process(raw, output, 0.001f);
+    CHECK(std::fabs(output[0][0] + 1.0f) < 1e-5f);
+}
+
+static void Bench()
+{
+    static AxisFilterBank bank;
+    ConfigureVaried(bank);
+
+    std::mt19937 random(2);
+    static RawAxes frames[256] {};
+    for (size_t frame = 1; frame < 256; frame++)
+    {
+        memcpy(frames[frame], frames[frame - 1], sizeof(RawAxes));
+        NextFrame(random, frames[frame]);
+    }
+
+    FilteredAxes output;
+    float sum = 0;
+    size_t frame = 0;
+    double scalarNs = TimePerCall(200000, [&]
+    {
+        bank.ProcessScalar(frames[frame++ % 256], output, 0.001f);
+        sum += output[frame % MaxDeviceSlots][0];
+    });
+    printf("16 slots x 8 axes: portable %.0f ns per pass (%.2f ns per axis)", scalarNs, scalarNs / AxisFilterBank::LaneCount);
+
+#ifdef WGIC_AXIS_FILTER_SSE2
+    double sse2Ns = TimePerCall(200000, [&]
+    {
+        bank.ProcessSse2(frames[frame++ % 256], output, 0.001f);
+        sum += output[frame % MaxDeviceSlots][0];
+    });
+    printf(", SSE2 %.0f ns per pass (%.2f ns per axis), %.1fx", sse2Ns, sse2Ns / AxisFilterBank::LaneCount, scalarNs / sse2Ns);
+#endif
+    printf(" (checksum %g)\n", sum);
+}
+
+int main(int argc, char** argv)
+{
+    TestEquivalence();
+    TestKnownValues();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("AxisFilterBankTest");
+}
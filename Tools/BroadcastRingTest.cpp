@@ -0,0 +1,358 @@
+// Stress-tests BroadcastRing with one writer and several readers, as threads sharing a LocalBroadcastRing and, on
+// POSIX, as forked processes reading through SharedMemory and BroadcastReader. Every report carries a checksum of
+// its sequence number and data, so a torn read shows up, and every reader must account for each report as either
+// read or lost. With --bench it also measures the cost of publishing and reading, and of publishing with 1 to 8
+// subscriptions reading, as ICustomDevice.Subscribe sets up.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP BroadcastRingTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP BroadcastRingTest.cpp -o BroadcastRingTest
+//
+// Usage: BroadcastRingTest [--bench]
+
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "WGIC/BroadcastReader.h"
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#endif
+
+using namespace winrt::WGIC::Core;
+
+static constexpr uint32_t SlotCount = 64;
+static constexpr uint32_t DataSize = 48;
+static constexpr uint64_t Reports = 200000;
+static constexpr uint8_t EndKind = 0xFF;
+
+// Fills a report whose contents all follow from its sequence number, including some longer than the ring keeps
+static size_t MakeReport(uint64_t sequence, ReportRecord& record, uint8_t* data)
+{
+    size_t length = 1 + sequence % (DataSize + 8);
+    record = {};
+    record.Timestamp = sequence;
+    record.ReportId = static_cast<uint8_t>(sequence);
+    for (size_t i = 0; i < length; i++)
+        data[i] = static_cast<uint8_t>(sequence * 31 + i * 7);
+    return length;
+}
+
+static uint32_t Checksum(uint64_t sequence, const uint8_t* data, size_t length)
+{
+    uint32_t sum = static_cast<uint32_t>(sequence * 2654435761u);
+    for (size_t i = 0; i < length; i++)
+        sum = (sum ^ data[i]) * 16777619u;
+    return sum;
+}
+
+static void Publish(BroadcastRing& ring, uint64_t sequence)
+{
+    ReportRecord record;
+    uint8_t data[DataSize + 8];
+    size_t length = MakeReport(sequence, record, data);
+    record.Reserved = Checksum(sequence, data, length < DataSize ? length : DataSize);
+    ring.Publish(record, data, length);
+}
+
+static void PublishEnd(BroadcastRing& ring)
+{
+    ReportRecord record {};
+    record.Kind = EndKind;
+    uint8_t data[1] = {};
+    ring.Publish(record, data, 0);
+}
+
+// Publishes Reports reports and then the end marker. The writer alternates between bursts where it yields now and
+// then, so that even on a single core the readers keep up and are reading slots the writer is about to reuse, and
+// bursts at full speed, where the readers are lapped.
+static void PublishAll(BroadcastRing& ring)
+{
+    for (uint64_t sequence = 0; sequence < Reports; sequence++)
+    {
+        Publish(ring, sequence);
+        if ((sequence / 4096) % 2 == 0 && sequence % 16 == 0)
+            std::this_thread::yield();
+    }
+    PublishEnd(ring);
+}
+
+struct ReaderResult
+{
+    uint64_t Read = 0;
+    uint64_t Lost = 0;
+    uint64_t Torn = 0;
+    uint64_t OutOfOrder = 0;
+};
+
+// Reads until the end marker, checking every report against what the writer would have published
+template<typename TRead>
+static void ReadAll(TRead&& read, ReaderResult& result)
+{
+    ReportRecord record;
+    uint8_t data[DataSize];
+    uint64_t last = 0;
+    bool first = true;
+    while (true)
+    {
+        if (!read(record, data))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        result.Read++;
+        if (record.Kind == EndKind)
+            return;
+
+        uint64_t sequence = record.Timestamp;
+        size_t fullLength = 1 + sequence % (DataSize + 8);
+        if (record.FullLength != fullLength || record.Length != (fullLength < DataSize ? fullLength : DataSize) ||
+            record.ReportId != static_cast<uint8_t>(sequence) || record.Reserved != Checksum(sequence, data, record.Length))
+        {
+            result.Torn++;
+        }
+
+        if (!first && sequence <= last)
+            result.OutOfOrder++;
+        first = false;
+        last = sequence;
+    }
+}
+
+static void CheckReader(ReaderResult const& result, uint64_t published)
+{
+    CHECK(result.Torn == 0);
+    CHECK(result.OutOfOrder == 0);
+    CHECK(result.Read + result.Lost == published);
+}
+
+static void TestThreads()
+{
+    LocalBroadcastRing local(SlotCount, DataSize);
+    BroadcastRing& ring = local.Ring();
+
+    constexpr size_t ReaderCount = 4;
+    std::vector<BroadcastCursor> cursors(ReaderCount);
+    for (auto& cursor : cursors)
+        cursor.Reset(ring, false);
+
+    std::vector<ReaderResult> results(ReaderCount);
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < ReaderCount; i++)
+    {
+        readers.emplace_back([&, i]
+        {
+            ReadAll([&](ReportRecord& record, uint8_t* data) { return cursors[i].Read(ring, record, data, DataSize); },
+                results[i]);
+            results[i].Lost = cursors[i].Lost();
+        });
+    }
+
+    PublishAll(ring);
+
+    uint64_t lost = 0;
+    for (size_t i = 0; i < ReaderCount; i++)
+    {
+        readers[i].join();
+        CheckReader(results[i], Reports + 1);
+        lost += results[i].Lost;
+    }
+
+    CHECK(ring.WriteSequence() == Reports + 1);
+    printf("Threads: %zu readers lost %.1f%% of %llu reports on average\n", ReaderCount,
+        100.0 * lost / ReaderCount / Reports, static_cast<unsigned long long>(Reports));
+}
+
+#ifndef _WIN32
+static void TestProcesses()
+{
+    std::string name = "wgic-ring-test." + std::to_string(getpid());
+    SharedMemory memory;
+    CHECK(memory.Create(name, BroadcastRing::RequiredSize(SlotCount, DataSize)));
+    BroadcastRing ring;
+    CHECK(ring.Initialize(memory.Data(), memory.Size(), SlotCount, DataSize));
+
+    // Each child says when it has attached, so that none of them starts after reports were already overwritten,
+    // then sends back its result
+    constexpr size_t ReaderCount = 3;
+    int pipes[ReaderCount][2];
+    pid_t children[ReaderCount];
+    for (size_t i = 0; i < ReaderCount; i++)
+    {
+        CHECK(pipe(pipes[i]) == 0);
+        children[i] = fork();
+        if (children[i] == 0)
+        {
+            BroadcastReader reader;
+            ReaderResult result;
+            bool opened = reader.Open(name, false);
+            char ready = opened ? 1 : 0;
+            ssize_t written = write(pipes[i][1], &ready, 1);
+            if (opened)
+            {
+                ReadAll([&](ReportRecord& record, uint8_t* data) { return reader.Read(record, data); }, result);
+                result.Lost = reader.Lost();
+            }
+            written += write(pipes[i][1], &result, sizeof(result));
+            _exit(written == 1 + static_cast<ssize_t>(sizeof(result)) ? 0 : 1);
+        }
+    }
+
+    for (size_t i = 0; i < ReaderCount; i++)
+    {
+        char ready = 0;
+        CHECK(read(pipes[i][0], &ready, 1) == 1 && ready == 1);
+    }
+
+    PublishAll(ring);
+
+    for (size_t i = 0; i < ReaderCount; i++)
+    {
+        ReaderResult result;
+        CHECK(read(pipes[i][0], &result, sizeof(result)) == static_cast<ssize_t>(sizeof(result)));
+        CheckReader(result, Reports + 1);
+
+        int status = 0;
+        CHECK(waitpid(children[i], &status, 0) == children[i] && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        close(pipes[i][0]);
+        close(pipes[i][1]);
+    }
+}
+#endif
+
+static void TestLappedReader()
+{
+    LocalBroadcastRing local(SlotCount, DataSize);
+    BroadcastRing& ring = local.Ring();
+    BroadcastCursor cursor;
+    cursor.Reset(ring, false);
+
+    // Three rings' worth before reading, so all but the last ring is lost
+    for (uint64_t sequence = 0; sequence < SlotCount * 3; sequence++)
+        Publish(ring, sequence);
+    PublishEnd(ring);
+
+    ReaderResult result;
+    ReadAll([&](ReportRecord& record, uint8_t* data) { return cursor.Read(ring, record, data, DataSize); }, result);
+    result.Lost = cursor.Lost();
+    CheckReader(result, SlotCount * 3 + 1);
+    CHECK(result.Read == SlotCount);
+}
+
+static void Bench()
+{
+    LocalBroadcastRing local(1024, DataSize);
+    BroadcastRing& ring = local.Ring();
+    ReportRecord record;
+    uint8_t data[DataSize + 8];
+    size_t length = MakeReport(5, record, data);
+
+    double publishNs = TimePerCall(1000000, [&] { ring.Publish(record, data, length); });
+
+    // Each pass rereads the whole ring
+    BroadcastCursor cursor;
+    uint8_t copy[DataSize];
+    uint64_t sum = 0;
+    double readNs = TimePerCall(1000, [&]
+    {
+        cursor.Reset(ring, false);
+        while (cursor.Read(ring, record, copy, DataSize))
+            sum += copy[0];
+    }) / 1024;
+
+    printf("Publish %.1f ns per report, read %.1f ns per report (checksum %llu)\n", publishNs, readNs,
+        static_cast<unsigned long long>(sum));
+}
+
+// Stands in for ReportSubscription: a cursor on a device's ring, guarded by a lock only its own reader takes
+struct Subscription
+{
+    std::mutex Lock;
+    BroadcastCursor Cursor;
+
+    bool ReadNext(BroadcastRing const& ring, ReportRecord& record, uint8_t* data)
+    {
+        std::lock_guard<std::mutex> lock(Lock);
+        return Cursor.Read(ring, record, data, DataSize);
+    }
+};
+
+// What a device's input sink costs with 1 to 8 subscriptions reading its ring at the same time. The sink publishes
+// under the lock it already holds for queueing; readers never take it.
+static void BenchSubscribers()
+{
+    constexpr uint64_t Published = 100000;
+    for (size_t readerCount = 1; readerCount <= 8; readerCount++)
+    {
+        LocalBroadcastRing local(64, DataSize);
+        BroadcastRing& ring = local.Ring();
+        std::mutex sinkLock;
+
+        std::vector<Subscription> subscriptions(readerCount);
+        for (auto& subscription : subscriptions)
+            subscription.Cursor.Reset(ring, false);
+
+        std::vector<ReaderResult> results(readerCount);
+        std::vector<std::thread> readers;
+        for (size_t i = 0; i < readerCount; i++)
+        {
+            readers.emplace_back([&, i]
+            {
+                ReadAll([&](ReportRecord& record, uint8_t* data) { return subscriptions[i].ReadNext(ring, record, data); },
+                    results[i]);
+                std::lock_guard<std::mutex> lock(subscriptions[i].Lock);
+                results[i].Lost = subscriptions[i].Cursor.Lost();
+            });
+        }
+
+        // At full speed, and then yielding every 16 reports so that the readers keep up even on a single core.
+        // The second includes the readers' time whenever they share the writer's core.
+        uint64_t sequence = 0;
+        double publishNs = TimePerCall(Published / 2, [&]
+        {
+            std::lock_guard<std::mutex> lock(sinkLock);
+            Publish(ring, sequence++);
+        });
+        double pacedNs = TimePerCall(Published / 2, [&]
+        {
+            {
+                std::lock_guard<std::mutex> lock(sinkLock);
+                Publish(ring, sequence++);
+            }
+            if (sequence % 16 == 0)
+                std::this_thread::yield();
+        });
+        PublishEnd(ring);
+
+        uint64_t read = 0;
+        for (size_t i = 0; i < readerCount; i++)
+        {
+            readers[i].join();
+            CheckReader(results[i], Published + 1);
+            read += results[i].Read;
+        }
+
+        printf("%zu subscriptions: %.0f ns per publish, %.0f ns paced; each read %.1f%% of %llu reports\n",
+            readerCount, publishNs, pacedNs, 100.0 * read / readerCount / (Published + 1),
+            static_cast<unsigned long long>(Published));
+    }
+}
+
+int main(int argc, char** argv)
+{
+    TestLappedReader();
+    TestThreads();
+#ifndef _WIN32
+    TestProcesses();
+#endif
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        Bench();
+        BenchSubscribers();
+    }
+
+    return CheckResult("BroadcastRingTest");
+}
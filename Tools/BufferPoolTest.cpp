@@ -0,0 +1,111 @@
+// Tests BufferPool, which report and message buffers come from: accounting against limits, and freeing buffers
+// without allocating, since that happens in destructors.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP BufferPoolTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP BufferPoolTest.cpp -o BufferPoolTest
+//
+// Usage: BufferPoolTest
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "WGIC/BufferPool.h"
+
+using namespace winrt::WGIC::Core;
+
+// Counts every allocation made through operator new
+static std::atomic<size_t> s_allocations { 0 };
+
+void* operator new(size_t size)
+{
+    s_allocations++;
+    if (void* memory = malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+static void TestAccounting()
+{
+    BufferPool pool(4096);
+    auto account = std::make_shared<BufferAccount>(1024);
+    {
+        auto small = pool.Allocate(account, 20);
+        CHECK(small.data() && small.size() == 20 && small.Capacity() == BufferPool::MinClassSize);
+        auto medium = pool.Allocate(account, 300);
+        CHECK(medium.Capacity() == 512);
+        CHECK(account->Used() == 544);
+
+        // Over the account's limit
+        auto large = pool.Allocate(account, 600);
+        CHECK(!large.data());
+        CHECK(account->FailedAllocations() == 1);
+
+        // Over the pool's limit, for an account without one
+        auto unlimited = std::make_shared<BufferAccount>();
+        auto huge = pool.Allocate(unlimited, 8192);
+        CHECK(!huge.data());
+        CHECK(unlimited->Used() == 0);
+        CHECK(pool.GetStatistics().Buffers == 2);
+    }
+
+    CHECK(account->Used() == 0);
+    CHECK(account->Peak() == 544);
+    CHECK(pool.GetStatistics().Used == 0 && pool.GetStatistics().Buffers == 0);
+}
+
+// Frees the buffers, returning the number of allocations made while doing so
+static size_t AllocationsWhileFreeing(std::vector<PooledBuffer>& buffers)
+{
+    size_t before = s_allocations;
+    buffers.clear();
+    return s_allocations - before;
+}
+
+static std::vector<PooledBuffer> AllocateMany(BufferPool& pool, std::shared_ptr<BufferAccount> const& account)
+{
+    std::vector<PooledBuffer> buffers;
+    buffers.reserve(BufferPool::ClassCount * 100 + 1);
+    for (size_t i = 0; i < 100; i++)
+    {
+        for (uint32_t size = BufferPool::MinClassSize; size <= (BufferPool::MinClassSize << (BufferPool::ClassCount - 1)); size <<= 1)
+            buffers.push_back(pool.Allocate(account, size));
+    }
+    buffers.push_back(pool.Allocate(account, 10000));
+    return buffers;
+}
+
+static void TestFreeDoesNotAllocate()
+{
+    auto account = std::make_shared<BufferAccount>();
+
+    // Without thread caches
+    BufferPool pool;
+    auto buffers = AllocateMany(pool, account);
+    CHECK(AllocationsWhileFreeing(buffers) == 0);
+
+    // With them, including freeing on a thread that has never used the pool before
+    buffers = AllocateMany(BufferPool::Global(), account);
+    CHECK(AllocationsWhileFreeing(buffers) == 0);
+    buffers = AllocateMany(BufferPool::Global(), account);
+    std::thread([&] { CHECK(AllocationsWhileFreeing(buffers) == 0); }).join();
+    CHECK(account->Used() == 0);
+}
+
+int main()
+{
+    TestAccounting();
+    TestFreeDoesNotAllocate();
+    return CheckResult("BufferPoolTest");
+}
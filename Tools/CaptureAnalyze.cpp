@@ -0,0 +1,431 @@
+// Summarizes the reports in a flight recording made by WGIC::FlightRecorder, to help work out the layout of
+// an unfamiliar device's reports. For each kind of report (device, message class and report ID) from each connected
+// device, told apart by their state slots, it prints:
+//   - how often it arrives and how long it is
+//   - how often each byte and bit changes from one report to the next, and each byte's entropy
+//   - pairs of bits that tend to change together, such as the two halves of an axis
+// The recording is split into chunks analyzed in parallel, with the results merged per kind of report.
+// Only depends on the standard library and the WGIC core headers, so it builds as a plain console program:
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP CaptureAnalyze.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP CaptureAnalyze.cpp -o CaptureAnalyze
+//
+// Usage: CaptureAnalyze <recording> [--threads N] [--scaling]
+//   --scaling times the analysis with 1, 2, 4... threads up to the number of cores, instead of printing it
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "WGIC/FlightRecording.h"
+
+using namespace winrt::WGIC::Core;
+
+// Bytes beyond these are counted in the size distribution, but not analyzed
+constexpr size_t MaxAnalyzedBytes = 64;
+constexpr size_t MaxCorrelatedBits = 256;
+// Reports where more bits than this changed are left out of the correlation, which keeps its cost bounded
+constexpr size_t MaxCorrelatedChanges = 16;
+constexpr uint64_t ChunkSize = 1 << 16;
+
+// (stateSlot, vendorId, productId, kind, messageClass, reportId) packed together. The state slot tells apart two
+// devices of the same model connected at the same time, whose reports would otherwise be compared with each other.
+static uint64_t MakeKey(ReportRecord const& record)
+{
+    return (static_cast<uint64_t>(static_cast<uint8_t>(record.StateSlot)) << 56) |
+        (static_cast<uint64_t>(record.VendorId) << 40) | (static_cast<uint64_t>(record.ProductId) << 24) |
+        (static_cast<uint64_t>(record.Kind) << 16) | (static_cast<uint64_t>(record.MessageClass) << 8) | record.ReportId;
+}
+
+struct ReportStats
+{
+    uint64_t Count = 0;
+    uint64_t FirstTimestamp = UINT64_MAX;
+    uint64_t LastTimestamp = 0;
+    uint64_t Intervals = 0;
+    uint64_t IntervalTotal = 0;
+    uint64_t MinInterval = UINT64_MAX;
+    uint64_t MaxInterval = 0;
+    std::map<uint32_t, uint64_t> Lengths;
+
+    // Change statistics compare each report with the one before it of the same kind
+    uint64_t Comparisons = 0;
+    uint64_t CorrelatedComparisons = 0;
+    std::vector<uint64_t> ByteChanges = std::vector<uint64_t>(MaxAnalyzedBytes);
+    std::vector<uint64_t> BitChanges = std::vector<uint64_t>(MaxAnalyzedBytes * 8);
+    std::vector<uint64_t> Values = std::vector<uint64_t>(MaxAnalyzedBytes * 256);
+    std::vector<uint32_t> CoChanges; // Upper triangle of a MaxCorrelatedBits square, allocated on first use
+
+    // Only used while analyzing a chunk
+    std::vector<uint8_t> Previous;
+    uint64_t PreviousTimestamp = 0;
+    bool HasPrevious = false;
+
+    void Add(ReportRecord const& record, const uint8_t* data)
+    {
+        Count++;
+        FirstTimestamp = std::min(FirstTimestamp, record.Timestamp);
+        LastTimestamp = std::max(LastTimestamp, record.Timestamp);
+        Lengths[record.FullLength]++;
+
+        size_t length = std::min<size_t>(record.Length, MaxAnalyzedBytes);
+        for (size_t i = 0; i < length; i++)
+            Values[i * 256 + data[i]]++;
+
+        if (HasPrevious)
+        {
+            uint64_t interval = record.Timestamp - PreviousTimestamp;
+            Intervals++;
+            IntervalTotal += interval;
+            MinInterval = std::min(MinInterval, interval);
+            MaxInterval = std::max(MaxInterval, interval);
+            Compare(data, length);
+        }
+
+        Previous.assign(data, data + length);
+        PreviousTimestamp = record.Timestamp;
+        HasPrevious = true;
+    }
+
+    void Merge(ReportStats const& other)
+    {
+        Count += other.Count;
+        FirstTimestamp = std::min(FirstTimestamp, other.FirstTimestamp);
+        LastTimestamp = std::max(LastTimestamp, other.LastTimestamp);
+        Intervals += other.Intervals;
+        IntervalTotal += other.IntervalTotal;
+        MinInterval = std::min(MinInterval, other.MinInterval);
+        MaxInterval = std::max(MaxInterval, other.MaxInterval);
+        for (auto const& length : other.Lengths)
+            Lengths[length.first] += length.second;
+
+        Comparisons += other.Comparisons;
+        CorrelatedComparisons += other.CorrelatedComparisons;
+        AddAll(ByteChanges, other.ByteChanges);
+        AddAll(BitChanges, other.BitChanges);
+        AddAll(Values, other.Values);
+        if (!other.CoChanges.empty())
+        {
+            CoChanges.resize(other.CoChanges.size());
+            AddAll(CoChanges, other.CoChanges);
+        }
+    }
+
+private:
+    void Compare(const uint8_t* data, size_t length)
+    {
+        Comparisons++;
+
+        uint16_t changedBits[MaxCorrelatedChanges];
+        size_t changedCount = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            uint8_t changed = data[i] ^ (i < Previous.size() ? Previous[i] : 0);
+            if (changed == 0)
+                continue;
+
+            ByteChanges[i]++;
+            for (size_t bit = 0; bit < 8; bit++)
+            {
+                if ((changed & (1 << bit)) == 0)
+                    continue;
+
+                size_t index = i * 8 + bit;
+                BitChanges[index]++;
+                if (index < MaxCorrelatedBits)
+                {
+                    if (changedCount < MaxCorrelatedChanges)
+                        changedBits[changedCount] = static_cast<uint16_t>(index);
+                    changedCount++;
+                }
+            }
+        }
+
+        if (changedCount == 0 || changedCount > MaxCorrelatedChanges)
+            return;
+
+        if (CoChanges.empty())
+            CoChanges.resize(MaxCorrelatedBits * MaxCorrelatedBits);
+        CorrelatedComparisons++;
+        for (size_t a = 0; a < changedCount; a++)
+        {
+            for (size_t b = a + 1; b < changedCount; b++)
+                CoChanges[changedBits[a] * MaxCorrelatedBits + changedBits[b]]++;
+        }
+    }
+
+    template<typename T, typename U>
+    static void AddAll(std::vector<T>& into, std::vector<U> const& from)
+    {
+        for (size_t i = 0; i < from.size(); i++)
+            into[i] += static_cast<T>(from[i]);
+    }
+};
+
+using StatsMap = std::unordered_map<uint64_t, ReportStats>;
+
+// Analyzes every report still in the ring, using the given number of threads
+static std::map<uint64_t, ReportStats> Analyze(BroadcastRing const& ring, unsigned threadCount, uint64_t& unreadable)
+{
+    uint64_t end = ring.WriteSequence();
+    uint64_t begin = end > ring.SlotCount() ? end - ring.SlotCount() : 0;
+    uint64_t chunkCount = (end - begin + ChunkSize - 1) / ChunkSize;
+
+    // Chunks are handed out as workers finish their last one, so a slow worker doesn't hold up the rest
+    std::atomic<uint64_t> nextChunk { 0 };
+    std::atomic<uint64_t> lost { 0 };
+    std::vector<StatsMap> results(threadCount);
+    std::vector<std::thread> workers;
+    for (unsigned worker = 0; worker < threadCount; worker++)
+    {
+        workers.emplace_back([&, worker]
+        {
+            std::vector<uint8_t> data(ring.DataSize());
+            StatsMap& stats = results[worker];
+            uint64_t workerLost = 0;
+            for (uint64_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++)
+            {
+                // Reports aren't compared across chunks, since the previous one was seen by another worker
+                for (auto& entry : stats)
+                    entry.second.HasPrevious = false;
+
+                uint64_t first = begin + chunk * ChunkSize;
+                uint64_t last = std::min(first + ChunkSize, end);
+                ReportRecord record;
+                for (uint64_t sequence = first; sequence < last; sequence++)
+                {
+                    if (ring.TryRead(sequence, record, data.data(), data.size()))
+                        stats[MakeKey(record)].Add(record, data.data());
+                    else
+                        workerLost++;
+                }
+            }
+
+            lost += workerLost;
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    // Merged per kind of report, with each kind on its own thread
+    std::map<uint64_t, ReportStats> merged;
+    for (auto const& result : results)
+    {
+        for (auto const& entry : result)
+            merged[entry.first];
+    }
+
+    std::vector<ReportStats*> targets;
+    std::vector<uint64_t> keys;
+    for (auto& entry : merged)
+    {
+        keys.push_back(entry.first);
+        targets.push_back(&entry.second);
+    }
+
+    std::atomic<size_t> nextKey { 0 };
+    workers.clear();
+    for (unsigned worker = 0; worker < threadCount; worker++)
+    {
+        workers.emplace_back([&]
+        {
+            for (size_t key = nextKey++; key < keys.size(); key = nextKey++)
+            {
+                for (auto const& result : results)
+                {
+                    auto found = result.find(keys[key]);
+                    if (found != result.end())
+                        targets[key]->Merge(found->second);
+                }
+            }
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+
+    unreadable = lost;
+    return merged;
+}
+
+static double Entropy(const uint64_t* histogram, uint64_t total)
+{
+    double entropy = 0;
+    for (size_t value = 0; value < 256; value++)
+    {
+        if (histogram[value] == 0)
+            continue;
+
+        double p = static_cast<double>(histogram[value]) / total;
+        entropy -= p * std::log2(p);
+    }
+
+    return entropy;
+}
+
+static void Print(uint64_t key, ReportStats const& stats)
+{
+    static const char* kinds[] = { "Hid", "Xusb", "Gip" };
+    uint8_t kind = static_cast<uint8_t>(key >> 16);
+    int8_t slot = static_cast<int8_t>(key >> 56);
+    printf("== slot %d %s %04X:%04X class %u id 0x%02X: %llu reports", slot, kind < 3 ? kinds[kind] : "?",
+        static_cast<unsigned>((key >> 40) & 0xFFFF), static_cast<unsigned>((key >> 24) & 0xFFFF),
+        static_cast<unsigned>((key >> 8) & 0xFF), static_cast<unsigned>(key & 0xFF),
+        static_cast<unsigned long long>(stats.Count));
+
+    // Timestamps are in microseconds
+    if (stats.Intervals > 0)
+    {
+        printf(", %.1f Hz, interval %.0f us (min %llu, max %llu)",
+            stats.LastTimestamp > stats.FirstTimestamp ? (stats.Count - 1) * 1e6 / (stats.LastTimestamp - stats.FirstTimestamp) : 0.0,
+            static_cast<double>(stats.IntervalTotal) / stats.Intervals,
+            static_cast<unsigned long long>(stats.MinInterval), static_cast<unsigned long long>(stats.MaxInterval));
+    }
+    printf("\n");
+
+    printf("   lengths:");
+    uint32_t longest = 0;
+    for (auto const& length : stats.Lengths)
+    {
+        printf(" %u (%.1f%%)", length.first, 100.0 * length.second / stats.Count);
+        longest = std::max(longest, length.first);
+    }
+    printf("\n");
+
+    printf("   byte  changes  entropy  distinct  common  bit changes (bit 0 first)\n");
+    for (size_t i = 0; i < std::min<size_t>(longest, MaxAnalyzedBytes); i++)
+    {
+        const uint64_t* histogram = &stats.Values[i * 256];
+        uint64_t total = 0;
+        size_t distinct = 0;
+        size_t common = 0;
+        for (size_t value = 0; value < 256; value++)
+        {
+            total += histogram[value];
+            distinct += histogram[value] != 0;
+            if (histogram[value] > histogram[common])
+                common = value;
+        }
+
+        double comparisons = stats.Comparisons > 0 ? static_cast<double>(stats.Comparisons) : 1.0;
+        printf("   %4zu  %6.2f%%  %7.3f  %8zu    0x%02zX ", i, 100.0 * stats.ByteChanges[i] / comparisons,
+            total > 0 ? Entropy(histogram, total) : 0.0, distinct, common);
+        if (stats.ByteChanges[i] > 0)
+        {
+            for (size_t bit = 0; bit < 8; bit++)
+                printf(" %6.2f", 100.0 * stats.BitChanges[i * 8 + bit] / comparisons);
+        }
+        printf("\n");
+    }
+
+    if (stats.CoChanges.empty())
+        return;
+
+    // Bits that change together more often than chance, by the phi coefficient of their change indicators.
+    // Bits that change in every report (or never) carry no information and are skipped.
+    struct Pair
+    {
+        size_t A, B;
+        double Score;
+        uint32_t Count;
+    };
+    std::vector<Pair> pairs;
+    for (size_t a = 0; a < MaxCorrelatedBits; a++)
+    {
+        for (size_t b = a + 1; b < MaxCorrelatedBits; b++)
+        {
+            uint32_t count = stats.CoChanges[a * MaxCorrelatedBits + b];
+            if (count < 8)
+                continue;
+
+            double n = static_cast<double>(stats.Comparisons);
+            double changesA = static_cast<double>(stats.BitChanges[a]);
+            double changesB = static_cast<double>(stats.BitChanges[b]);
+            double variance = changesA * (n - changesA) * changesB * (n - changesB);
+            if (variance <= 0)
+                continue;
+
+            double score = (count * n - changesA * changesB) / std::sqrt(variance);
+            pairs.push_back({ a, b, score, count });
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end(), [](Pair const& x, Pair const& y) { return x.Score > y.Score; });
+    printf("   correlated bits (byte.bit, from %llu of %llu comparisons):\n",
+        static_cast<unsigned long long>(stats.CorrelatedComparisons), static_cast<unsigned long long>(stats.Comparisons));
+    for (size_t i = 0; i < std::min<size_t>(pairs.size(), 12); i++)
+    {
+        printf("     %zu.%zu ~ %zu.%zu  %.2f (%u together)\n", pairs[i].A / 8, pairs[i].A % 8, pairs[i].B / 8,
+            pairs[i].B % 8, pairs[i].Score, pairs[i].Count);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <recording> [--threads N] [--scaling]\n", argv[0]);
+        return 2;
+    }
+
+    unsigned threadCount = std::max(1u, std::thread::hardware_concurrency());
+    bool scaling = false;
+    for (int i = 2; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threadCount = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--scaling") == 0)
+            scaling = true;
+    }
+
+    FlightRecording recording;
+    if (!recording.Open(argv[1]))
+    {
+        fprintf(stderr, "%s is not a flight recording\n", argv[1]);
+        return 1;
+    }
+
+    auto const& ring = recording.Ring();
+    uint64_t unreadable = 0;
+    if (scaling)
+    {
+        // The first pass also pulls the file into the page cache, so it isn't counted
+        Analyze(ring, std::max(1u, std::thread::hardware_concurrency()), unreadable);
+
+        double bytes = static_cast<double>(BroadcastRing::RequiredSize(ring.SlotCount(), ring.DataSize()));
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        double baseline = 0;
+        for (unsigned threads = 1;; threads = std::min(threads * 2, cores))
+        {
+            auto start = std::chrono::steady_clock::now();
+            Analyze(ring, threads, unreadable);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (threads == 1)
+                baseline = seconds;
+
+            printf("%3u threads: %.3f s, %.0f MB/s, %.2fx\n", threads, seconds, bytes / seconds / 1e6, baseline / seconds);
+            if (threads == cores)
+                break;
+        }
+
+        return 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto results = Analyze(ring, threadCount, unreadable);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto const& entry : results)
+        Print(entry.first, entry.second);
+
+    printf("# %llu unreadable reports, analyzed with %u threads in %.3f s\n",
+        static_cast<unsigned long long>(unreadable), threadCount, seconds);
+    return 0;
+}
@@ -0,0 +1,45 @@
+// Minimal checking and timing helpers for the test programs in this directory, which only depend on the standard
+// library so that the portable parts of the project can be tested without the UWP toolchain.
+#pragma once
+#include <chrono>
+#include <cstdio>
+
+inline int& CheckFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            CheckFailures()++; \
+        } \
+    } while (false)
+
+// Prints the outcome of the checks and returns the process exit code
+inline int CheckResult(const char* name)
+{
+    if (CheckFailures() == 0)
+    {
+        printf("%s: all checks passed\n", name);
+        return 0;
+    }
+
+    printf("%s: %d checks failed\n", name, CheckFailures());
+    return 1;
+}
+
+// Calls func() count times, returning the average time per call in nanoseconds
+template<typename TFunc>
+double TimePerCall(size_t count, TFunc&& func)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++)
+        func();
+
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / count;
+}
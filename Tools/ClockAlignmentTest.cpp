@@ -0,0 +1,171 @@
+// Tests ClockEstimator against synthetic device and host clocks with a known offset, skew and drift. Reports are
+// produced at 1 kHz for 60 s and arrive 300 us late plus exponential jitter (mean 150 us), with 1% held a further
+// 20-70 ms and a 0.5 s stall every 10 s. The estimate is checked against the minimum-latency arrival time. With
+// --bench it also measures the cost of adding a sample and converting a timestamp.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP ClockAlignmentTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP ClockAlignmentTest.cpp -o ClockAlignmentTest
+//
+// Usage: ClockAlignmentTest [--bench]
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include "Check.h"
+#include "WGIC/ClockAlignment.h"
+
+using namespace winrt::WGIC::Core;
+
+static constexpr double MinimumDelay = 300;
+
+struct Scenario
+{
+    const char* Name;
+    double SkewPpm;         // How much faster the device clock runs than the host's at the start
+    double DriftPpmPerSec;  // How fast the skew changes
+};
+
+struct Outcome
+{
+    double MeanError = 0;
+    double WorstError = 0;
+    double EndSkewPpm = 0;  // The true skew at the end, to compare DriftPpm with
+};
+
+static Outcome Simulate(ClockEstimator& estimator, Scenario const& scenario, uint32_t seed)
+{
+    std::mt19937_64 random(seed);
+    std::exponential_distribution<double> jitter(1.0 / 150);
+    std::uniform_real_distribution<double> uniform(0, 1);
+
+    // Neither clock starts anywhere near zero, or near the other
+    double device = 5e9;
+    double host = 1e12;
+    double errorSum = 0;
+    uint64_t errors = 0;
+    Outcome outcome;
+    for (uint64_t i = 0; i < 60000; i++)
+    {
+        double seconds = i / 1000.0;
+        double skew = (scenario.SkewPpm + scenario.DriftPpmPerSec * seconds) * 1e-6;
+        device += 1000;
+        host += 1000 / (1 + skew);
+        outcome.EndSkewPpm = skew * 1e6;
+
+        double arrival = host + MinimumDelay + jitter(random);
+        if (uniform(random) < 0.01)
+            arrival += 20000 + 50000 * uniform(random);
+
+        // Everything that would have arrived during a stall arrives when it ends
+        double sinceStall = std::fmod(seconds, 10.0);
+        if (seconds >= 10 && sinceStall < 0.5)
+            arrival = std::max(arrival, host + (0.5 - sinceStall) * 1e6);
+
+        estimator.AddSample(static_cast<uint64_t>(device), static_cast<uint64_t>(arrival));
+
+        // Once the first 6.4 s window has filled
+        if (seconds >= 6.4)
+        {
+            double error = std::abs(static_cast<double>(estimator.ToHost(static_cast<uint64_t>(device))) -
+                (host + MinimumDelay));
+            errorSum += error;
+            errors++;
+            outcome.WorstError = std::max(outcome.WorstError, error);
+        }
+    }
+
+    outcome.MeanError = errorSum / errors;
+    return outcome;
+}
+
+// The bounds quoted when ClockEstimator was added. For a skew changing at 20 ppm/s, the error is the lag of a linear
+// fit over a 6.4 s window, so the worst case depends on where the stalls fall; across seeds it reaches 170 us.
+static void TestAlignment()
+{
+    struct
+    {
+        Scenario Clocks;
+        double MeanBound;
+        double WorstBound;
+    } const cases[] = {
+        { { "Same rate", 0, 0 }, 1.0, 2 },
+        { { "200 ppm fast", 200, 0 }, 2.9, 5 },
+        { { "Drifting 1 ppm/s", 0, 1 }, 6.5, 9 },
+        { { "Drifting 20 ppm/s", 0, 20 }, 85, 180 },
+    };
+
+    for (auto const& test : cases)
+    {
+        for (uint32_t seed = 1; seed <= 3; seed++)
+        {
+            ClockEstimator estimator;
+            Outcome outcome = Simulate(estimator, test.Clocks, seed);
+            CHECK(estimator.Fitted());
+            CHECK(outcome.MeanError <= test.MeanBound);
+            CHECK(outcome.WorstError <= test.WorstBound);
+            if (test.Clocks.DriftPpmPerSec == 0)
+                CHECK(std::abs(estimator.DriftPpm() - outcome.EndSkewPpm) < 1);
+
+            if (seed == 1)
+            {
+                printf("%s: drift read %.1f ppm (true %.1f), mean error %.1f us, worst %.0f us\n", test.Clocks.Name,
+                    estimator.DriftPpm(), outcome.EndSkewPpm, outcome.MeanError, outcome.WorstError);
+            }
+        }
+    }
+}
+
+static void TestBeforeFit()
+{
+    ClockEstimator estimator;
+    CHECK(estimator.ToHost(1234) == 1234);
+
+    // Until there are three buckets, the clocks are assumed to run at the same rate from the earliest arrival
+    estimator.AddSample(1000, 50500);
+    estimator.AddSample(1500, 50900);
+    CHECK(!estimator.Fitted());
+    CHECK(estimator.ToHost(2000) == 51400);
+}
+
+static void TestTimeBaseReset()
+{
+    ClockEstimator estimator;
+    Simulate(estimator, { "", 0, 0 }, 1);
+    CHECK(estimator.Fitted());
+
+    // A device timestamp going backwards starts over rather than extrapolating the old fit
+    estimator.AddSample(100, 7000);
+    CHECK(!estimator.Fitted());
+    CHECK(estimator.ToHost(200) == 7100);
+}
+
+static void Bench()
+{
+    ClockEstimator estimator;
+    uint64_t device = 5000000000;
+    uint64_t host = 1000000000000;
+    double addNs = TimePerCall(1000000, [&]
+    {
+        device += 1000;
+        host += 1000;
+        estimator.AddSample(device, host + 300 + device % 97);
+    });
+
+    uint64_t sum = 0;
+    double toHostNs = TimePerCall(1000000, [&] { sum += estimator.ToHost(device -= 7); });
+
+    // Most AddSample calls only compare against the bucket's earliest sample; one in 100 refits
+    printf("AddSample %.1f ns on average at 1 kHz, ToHost %.1f ns (checksum %llu)\n", addNs, toHostNs,
+        static_cast<unsigned long long>(sum % 1000));
+}
+
+int main(int argc, char** argv)
+{
+    TestBeforeFit();
+    TestTimeBaseReset();
+    TestAlignment();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("ClockAlignmentTest");
+}
@@ -0,0 +1,236 @@
+// Tests DeviceLifecycle, which orders ConnectDevice, DisconnectDevice and AbandonDevice: a device removed before
+// it's announced, setup failing before and during DeviceAdded, event handlers calling back into the lifecycle, and
+// connection racing removal on two threads. Every scenario runs on its own thread, so that one deadlocking fails the
+// test rather than hanging it.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP DeviceLifecycleTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP DeviceLifecycleTest.cpp -o DeviceLifecycleTest
+//
+// Usage: DeviceLifecycleTest
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "Check.h"
+#include "WGIC/DeviceLifecycle.h"
+
+using namespace winrt::WGIC::Core;
+using namespace std::chrono_literals;
+
+// Waits up to 10 s, far longer than any scenario takes unless it deadlocked
+template<typename TCondition>
+static bool WaitFor(TCondition&& condition)
+{
+    for (int i = 0; i < 2000 && !condition(); i++)
+        std::this_thread::sleep_for(5ms);
+    return condition();
+}
+
+// The device list and events that CustomDevice keeps, recording the events in the order they're raised
+struct Device
+{
+    DeviceLifecycle Lifecycle;
+    std::mutex ListLock;
+    bool Listed = false;
+    std::string Events;
+    std::function<void()> OnAdded;
+
+    bool Connect()
+    {
+        return Lifecycle.Connect(
+            [&]
+            {
+                std::lock_guard<std::mutex> lock(ListLock);
+                bool added = !Listed;
+                Listed = true;
+                return added;
+            },
+            [&]
+            {
+                Events += "added ";
+                if (OnAdded)
+                    OnAdded();
+            },
+            [&] { Events += "removed "; });
+    }
+
+    void Disconnect()
+    {
+        bool unlisted = Lifecycle.Remove([&]
+        {
+            std::lock_guard<std::mutex> lock(ListLock);
+            bool removed = Listed;
+            Listed = false;
+            return removed;
+        });
+
+        if (unlisted)
+            Events += "removed ";
+    }
+};
+
+static void RunScenario(std::function<void()> scenario)
+{
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    std::thread([scenario, done]
+    {
+        scenario();
+        *done = true;
+    }).detach();
+    CHECK(WaitFor([&] { return done->load(); }));
+}
+
+static void TestConnectThenRemove()
+{
+    RunScenario([]
+    {
+        Device device;
+        CHECK(!device.Lifecycle.Ready());
+        CHECK(device.Connect());
+        CHECK(device.Lifecycle.Ready() && device.Listed);
+        device.Disconnect();
+        CHECK(!device.Listed);
+        CHECK(device.Events == "added removed ");
+
+        // Removal reported twice only raises the event once
+        device.Disconnect();
+        CHECK(device.Events == "added removed ");
+    });
+}
+
+static void TestRemovedBeforeReady()
+{
+    RunScenario([]
+    {
+        Device device;
+        device.Disconnect();
+        CHECK(!device.Connect());
+        CHECK(!device.Lifecycle.Ready() && !device.Listed);
+        CHECK(device.Events.empty());
+    });
+}
+
+// The handler runs with no lifecycle lock held, so removing the device from within it doesn't deadlock. The removal
+// is held back until DeviceAdded has returned, so the events stay in order.
+static void TestRemovedDuringAdded()
+{
+    RunScenario([]
+    {
+        Device device;
+        device.OnAdded = [&]
+        {
+            device.Disconnect();
+            CHECK(device.Events == "added ");
+        };
+        CHECK(device.Connect());
+        CHECK(!device.Listed);
+        CHECK(device.Events == "added removed ");
+    });
+}
+
+// Handlers may also look at the device, or call Connect for another device, which takes its own lock
+static void TestHandlersReenter()
+{
+    RunScenario([]
+    {
+        Device device, other;
+        device.OnAdded = [&]
+        {
+            CHECK(device.Lifecycle.Ready());
+            CHECK(other.Connect());
+        };
+        CHECK(device.Connect());
+        CHECK(device.Events == "added " && other.Events == "added ");
+    });
+}
+
+static void TestSetupFailure()
+{
+    // Failing before the device was listed: it never is, even if Connect were to run afterwards
+    RunScenario([]
+    {
+        Device device;
+        device.Lifecycle.Abandon();
+        CHECK(!device.Connect());
+        CHECK(!device.Lifecycle.Ready() && !device.Listed);
+        device.Disconnect();
+        CHECK(device.Events.empty());
+    });
+
+    // Failing in a DeviceAdded handler: it's listed, and removing it later still raises DeviceRemoved
+    RunScenario([]
+    {
+        Device device;
+        device.OnAdded = [] { throw std::runtime_error("handler failed"); };
+        bool threw = false;
+        try
+        {
+            device.Connect();
+        }
+        catch (std::runtime_error const&)
+        {
+            threw = true;
+            device.Lifecycle.Abandon();
+        }
+        CHECK(threw);
+        CHECK(device.Listed);
+
+        device.Disconnect();
+        CHECK(!device.Listed);
+        CHECK(device.Events == "added removed ");
+    });
+}
+
+// Connection and removal on two threads: however they interleave, a device is either never announced, or added and
+// then removed, and it always ends up unlisted
+static void TestRace()
+{
+    RunScenario([]
+    {
+        int announced = 0, unannounced = 0, wrong = 0;
+        for (int i = 0; i < 2000; i++)
+        {
+            Device device;
+            std::atomic<bool> go { false };
+            std::thread remover([&]
+            {
+                while (!go)
+                    std::this_thread::yield();
+                for (int spin = 0; spin < i % 50; spin++)
+                    std::this_thread::yield();
+                device.Disconnect();
+            });
+
+            // Either side may get in first, depending on how long each yields
+            go = true;
+            for (int spin = 0; spin < (i * 7) % 50; spin++)
+                std::this_thread::yield();
+            bool connected = device.Connect();
+            remover.join();
+
+            if (device.Listed || (device.Events != "" && device.Events != "added removed ") ||
+                connected != device.Lifecycle.Ready())
+            {
+                wrong++;
+            }
+            (device.Events.empty() ? unannounced : announced)++;
+        }
+
+        CHECK(wrong == 0);
+        printf("Race: %d devices announced and then removed, %d removed before being announced\n", announced,
+            unannounced);
+    });
+}
+
+int main()
+{
+    TestConnectThenRemove();
+    TestRemovedBeforeReady();
+    TestRemovedDuringAdded();
+    TestHandlersReenter();
+    TestSetupFailure();
+    TestRace();
+    return CheckResult("DeviceLifecycleTest");
+}
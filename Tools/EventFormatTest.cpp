@@ -0,0 +1,143 @@
+// Tests the event formatting in EventFormat.h, and with --bench measures its cost and counts its allocations
+// against formatting each event into new strings, as DeviceEntryControl did before.
+//   cl /std:c++17 /O2 /EHsc /utf-8 /I..\UWP_CPP /I<vcpkg>\installed\<triplet>\include EventFormatTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP EventFormatTest.cpp -o EventFormatTest
+//
+// Usage: EventFormatTest [--bench]
+
+#define FMT_HEADER_ONLY
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include "Check.h"
+#include "EventFormat.h"
+
+// Counts every allocation made through operator new, which is what fmt and std::wstring use
+static size_t s_allocations = 0;
+
+void* operator new(size_t size)
+{
+    s_allocations++;
+    if (void* memory = malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+static std::wstring ToString(fmt::wmemory_buffer const& buffer)
+{
+    return std::wstring(buffer.data(), buffer.size());
+}
+
+static void TestReport()
+{
+    fmt::wmemory_buffer buffer;
+    const uint8_t data[] = { 0x00, 0x7F, 0xA5 };
+    EventFormat::FormatReport(buffer, 1234, 0x0B, data, 3);
+    CHECK(ToString(buffer) == L"Timestamp: 1234, ID: 0x0B, length: 3\n00-7F-A5\n");
+
+    // Replaces what was there before
+    EventFormat::FormatReport(buffer, 5, 0, data, 1);
+    CHECK(ToString(buffer) == L"Timestamp: 5, ID: 0x00, length: 1\n00\n");
+
+    EventFormat::FormatReport(buffer, 5, 0, data, 0);
+    CHECK(ToString(buffer) == L"Timestamp: 5, ID: 0x00, length: 0\n\n");
+}
+
+static void TestMessage()
+{
+    fmt::wmemory_buffer buffer;
+    const uint8_t data[] = { 0xFF, 0x01 };
+    EventFormat::FormatGipMessage(buffer, 99, 1, 0x20, 7, data, 2);
+    CHECK(ToString(buffer) == L"Timestamp: 99, class: LowLatency, ID: 0x20, sequence: 7, length: 2\nFF-01\n");
+
+    // Unknown classes are shown by value
+    EventFormat::FormatGipMessage(buffer, 99, 9, 0x20, 7, data, 2);
+    CHECK(ToString(buffer) == L"Timestamp: 99, class: 9, ID: 0x20, sequence: 7, length: 2\nFF-01\n");
+}
+
+static void TestNoSteadyAllocations()
+{
+    fmt::wmemory_buffer buffer;
+    uint8_t data[64] = {};
+    EventFormat::FormatGipMessage(buffer, UINT64_MAX, 0, 0xFF, 0xFF, data, 64);
+
+    size_t before = s_allocations;
+    for (uint64_t i = 0; i < 1000; i++)
+    {
+        data[i % 64] = static_cast<uint8_t>(i);
+        EventFormat::FormatReport(buffer, i, 1, data, 64);
+        EventFormat::FormatGipMessage(buffer, i, 2, 0x20, static_cast<uint8_t>(i), data, 64);
+    }
+    CHECK(s_allocations == before);
+}
+
+// How DeviceEntryControl formatted events before: a new string for the hex and another for the event
+static std::wstring FormatReportWithStrings(uint64_t timestamp, uint8_t reportId, const uint8_t data[], uint32_t length)
+{
+    std::wstring hex;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        hex += EventFormat::s_hexDigits[data[i] >> 4];
+        hex += EventFormat::s_hexDigits[data[i] & 0x0F];
+        if (i < length - 1)
+            hex += L'-';
+    }
+
+    return fmt::format(L"Timestamp: {}, ID: 0x{:02X}, length: {}\n{}\n", timestamp, reportId, length, hex);
+}
+
+static void Bench()
+{
+    constexpr size_t Events = 1000000;
+    uint8_t data[64] = {};
+    uint64_t timestamp = 1000000000;
+    size_t checksum = 0;
+
+    fmt::wmemory_buffer buffer;
+    EventFormat::FormatReport(buffer, timestamp, 1, data, 64);
+    size_t before = s_allocations;
+    double bufferNs = TimePerCall(Events, [&]
+    {
+        data[timestamp % 64]++;
+        EventFormat::FormatReport(buffer, timestamp++, 1, data, 64);
+        checksum += buffer[buffer.size() - 2];
+    });
+    size_t bufferAllocations = s_allocations - before;
+
+    before = s_allocations;
+    double stringNs = TimePerCall(Events, [&]
+    {
+        data[timestamp % 64]++;
+        std::wstring event = FormatReportWithStrings(timestamp++, 1, data, 64);
+        checksum += event[event.size() - 2];
+    });
+    size_t stringAllocations = s_allocations - before;
+
+    printf("64-byte report events: reused buffer %.0f ns and %.2f allocations per event,"
+        " new strings %.0f ns and %.2f allocations per event (checksum %zu)\n",
+        bufferNs, static_cast<double>(bufferAllocations) / Events,
+        stringNs, static_cast<double>(stringAllocations) / Events, checksum);
+}
+
+int main(int argc, char** argv)
+{
+    TestReport();
+    TestMessage();
+    TestNoSteadyAllocations();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("EventFormatTest");
+}
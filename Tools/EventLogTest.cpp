@@ -0,0 +1,154 @@
+// Tests EventLog, the bounded log of event lines shown by MainPage, and with --bench measures it against the
+// 10k lines/s a busy device can produce.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP EventLogTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP EventLogTest.cpp -o EventLogTest
+//
+// Usage: EventLogTest [--bench]
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Check.h"
+#include "EventLog.h"
+
+// A line like the ones DeviceEntryControl formats for a 64-byte report
+static std::wstring MakeLine(uint64_t index)
+{
+    std::wstring line = L"Timestamp: " + std::to_wstring(index) + L", ID: 0x01, length: 64\n";
+    for (int i = 0; i < 64; i++)
+        line += i < 63 ? L"00-" : L"00\n";
+    return line;
+}
+
+static void TestFilling()
+{
+    EventLog log(4);
+    CHECK(log.Empty() && log.Capacity() == 4);
+    CHECK(log.Line(0).empty());
+
+    log.Push(L"a");
+    log.Push(L"b");
+    CHECK(log.Size() == 2);
+    CHECK(log.Line(0) == L"a" && log.Line(1) == L"b");
+    CHECK(log.Line(2).empty());
+}
+
+static void TestWrapping()
+{
+    EventLog log(3);
+    uint64_t generation = log.Generation();
+    for (int i = 0; i < 7; i++)
+        log.Push(std::to_wstring(i));
+
+    // Only the newest three are kept, oldest first
+    CHECK(log.Size() == 3);
+    CHECK(log.TotalPushed() == 7);
+    CHECK(log.Generation() == generation + 7);
+    CHECK(log.Line(0) == L"4" && log.Line(1) == L"5" && log.Line(2) == L"6");
+}
+
+static void TestRenderTail()
+{
+    EventLog log(5);
+    std::wstring output = L"stale";
+    log.RenderTail(output, 3);
+    CHECK(output.empty());
+
+    for (int i = 0; i < 8; i++)
+        log.Push(std::to_wstring(i) + L"\n");
+
+    log.RenderTail(output, 3);
+    CHECK(output == L"5\n6\n7\n");
+
+    // Asking for more lines than are kept renders all of them
+    log.RenderTail(output, 100);
+    CHECK(output == L"3\n4\n5\n6\n7\n");
+}
+
+static void TestClear()
+{
+    EventLog log(2);
+    log.Push(L"a");
+    log.Push(L"b");
+    log.Push(L"c");
+    uint64_t generation = log.Generation();
+
+    log.Clear();
+    CHECK(log.Empty() && log.TotalPushed() == 0);
+    CHECK(log.Generation() == generation + 1);
+
+    log.Push(L"d");
+    CHECK(log.Size() == 1 && log.Line(0) == L"d");
+}
+
+static void TestZeroCapacity()
+{
+    EventLog log(0);
+    CHECK(log.Capacity() == 1);
+    log.Push(L"a");
+    log.Push(L"b");
+    CHECK(log.Size() == 1 && log.Line(0) == L"b");
+}
+
+static void Bench()
+{
+    // MainPage keeps 256 lines and shows the newest 64
+    constexpr size_t Capacity = 256;
+    constexpr size_t Visible = 64;
+    constexpr uint64_t LinesPerSecond = 10000;
+    constexpr uint64_t FramesPerSecond = 60;
+    constexpr uint64_t Seconds = 10;
+
+    std::vector<std::wstring> lines;
+    for (uint64_t i = 0; i < 1024; i++)
+        lines.push_back(MakeLine(i));
+
+    EventLog log(Capacity);
+    std::wstring output;
+    uint64_t pushed = 0;
+    uint64_t frames = FramesPerSecond * Seconds;
+    double frameNs = TimePerCall(frames, [&]
+    {
+        // One frame's worth of lines, then the render the UI does once per frame
+        uint64_t count = LinesPerSecond / FramesPerSecond;
+        for (uint64_t i = 0; i < count; i++, pushed++)
+            log.Push(lines[pushed % lines.size()]);
+        log.RenderTail(output, Visible);
+    });
+
+    double busy = frameNs * FramesPerSecond / 1e9;
+    printf("10k lines/s at 60 frames/s: %.1f us per frame, %.2f%% of a core\n", frameNs / 1000, busy * 100);
+
+    double pushNs = TimePerCall(1000000, [&]
+    {
+        log.Push(lines[pushed++ % lines.size()]);
+    });
+    printf("Push alone: %.0f ns per line, %.1fM lines/s\n", pushNs, 1000 / pushNs);
+
+    // What MainPage did before: appending every line to the whole text so far
+    std::wstring text;
+    uint64_t concatenated = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::seconds(1))
+    {
+        text = text + lines[concatenated++ % lines.size()];
+    }
+    printf("Concatenating the whole log per line: %llu lines in the first second, %.1f MB of text\n",
+        static_cast<unsigned long long>(concatenated), text.size() * sizeof(wchar_t) / 1e6);
+}
+
+int main(int argc, char** argv)
+{
+    TestFilling();
+    TestWrapping();
+    TestRenderTail();
+    TestClear();
+    TestZeroCapacity();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("EventLogTest");
+}
@@ -0,0 +1,81 @@
+// Prints the reports in a flight recording made by WGIC::FlightRecorder, oldest first.
+// Only depends on the standard library and the WGIC core headers, so it builds as a plain console program:
+//   cl /std:c++17 /EHsc /I..\UWP_CPP FlightDecode.cpp
+//   g++ -std=c++17 -I../UWP_CPP FlightDecode.cpp -o FlightDecode
+//
+// Usage: FlightDecode <recording> [--hex]
+//
+// The test app records to FlightRecording.wgfr in its LocalState folder
+// (%LOCALAPPDATA%\Packages\<package family name>\LocalState). Each launch starts a new recording and keeps the
+// previous one as FlightRecording.prev.wgfr, so after a crash and relaunch that's the one to decode.
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "WGIC/FlightRecording.h"
+
+using namespace winrt::WGIC::Core;
+
+static const char* KindName(uint8_t kind)
+{
+    switch (kind)
+    {
+    case 0: return "Hid";
+    case 1: return "Xusb";
+    case 2: return "Gip";
+    default: return "?";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <recording> [--hex]\n", argv[0]);
+        return 2;
+    }
+
+    bool hex = argc > 2 && strcmp(argv[2], "--hex") == 0;
+
+    FlightRecording recording;
+    if (!recording.Open(argv[1]))
+    {
+        fprintf(stderr, "%s is not a flight recording\n", argv[1]);
+        return 1;
+    }
+
+    auto const& ring = recording.Ring();
+    uint64_t written = ring.WriteSequence();
+    printf("# Started at %llu us since the epoch, %llu reports recorded, room for %u\n",
+        static_cast<unsigned long long>(recording.Header().StartTime),
+        static_cast<unsigned long long>(written), ring.SlotCount());
+
+    BroadcastCursor cursor;
+    cursor.Reset(ring, false);
+
+    std::vector<uint8_t> data(ring.DataSize());
+    ReportRecord record;
+    uint64_t count = 0;
+    while (cursor.Read(ring, record, data.data(), data.size()))
+    {
+        printf("%llu %s %04X:%04X slot %d class %u id 0x%02X length %u",
+            static_cast<unsigned long long>(record.Timestamp), KindName(record.Kind), record.VendorId,
+            record.ProductId, record.StateSlot, record.MessageClass, record.ReportId, record.FullLength);
+        if (record.Length < record.FullLength)
+            printf(" (%u kept)", record.Length);
+
+        if (hex)
+        {
+            printf(" :");
+            for (uint16_t i = 0; i < record.Length; i++)
+                printf(" %02X", data[i]);
+        }
+        printf("\n");
+        count++;
+    }
+
+    // Reports torn by a crash mid-write show up as lost
+    printf("# %llu reports decoded, %llu unreadable\n", static_cast<unsigned long long>(count),
+        static_cast<unsigned long long>(cursor.Lost()));
+    return 0;
+}
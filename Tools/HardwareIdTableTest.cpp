@@ -0,0 +1,241 @@
+// Tests DeviceTableFile parsing, including malformed tables, and HardwareIdTable's merging and lookups. With --bench
+// it measures what DeviceTable.Register does at startup with 100k IDs, parsing and one AddRange, and the cost of a
+// lookup against the result.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP HardwareIdTableTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP HardwareIdTableTest.cpp -o HardwareIdTableTest
+//
+// Usage: HardwareIdTableTest [--bench]
+
+#include <cstring>
+#include <vector>
+#include "Check.h"
+#include "WGIC/HardwareIdTable.h"
+
+using namespace winrt::WGIC::Core;
+
+static void WriteUInt16(std::vector<uint8_t>& data, uint16_t value)
+{
+    data.push_back(static_cast<uint8_t>(value));
+    data.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void WriteUInt32(std::vector<uint8_t>& data, uint32_t value)
+{
+    WriteUInt16(data, static_cast<uint16_t>(value));
+    WriteUInt16(data, static_cast<uint16_t>(value >> 16));
+}
+
+// Builds a table file; the counts in the header can be overridden to describe more entries than there are
+static std::vector<uint8_t> MakeTable(std::vector<HardwareIdEntry> const& hardwareIds,
+    std::vector<InterfaceGuid> const& interfaceGuids, uint32_t hardwareIdCount, uint32_t interfaceGuidCount)
+{
+    std::vector<uint8_t> data(DeviceTableFile::Magic, DeviceTableFile::Magic + sizeof(DeviceTableFile::Magic));
+    WriteUInt16(data, DeviceTableFile::Version);
+    WriteUInt16(data, 0);
+    WriteUInt32(data, hardwareIdCount);
+    WriteUInt32(data, interfaceGuidCount);
+    for (auto const& hardwareId : hardwareIds)
+    {
+        WriteUInt16(data, hardwareId.VendorId);
+        WriteUInt16(data, hardwareId.ProductId);
+        WriteUInt16(data, hardwareId.Profile);
+    }
+    for (auto const& interfaceGuid : interfaceGuids)
+        data.insert(data.end(), interfaceGuid.begin(), interfaceGuid.end());
+    return data;
+}
+
+static std::vector<uint8_t> MakeTable(std::vector<HardwareIdEntry> const& hardwareIds,
+    std::vector<InterfaceGuid> const& interfaceGuids)
+{
+    return MakeTable(hardwareIds, interfaceGuids, static_cast<uint32_t>(hardwareIds.size()),
+        static_cast<uint32_t>(interfaceGuids.size()));
+}
+
+static void TestParseValid()
+{
+    InterfaceGuid guid;
+    for (size_t i = 0; i < guid.size(); i++)
+        guid[i] = static_cast<uint8_t>(0xA0 + i);
+    auto data = MakeTable({ { 0x045E, 0x028E, 3 }, { 0x1234, 0xABCD, HardwareIdTable::RejectedProfile } }, { guid });
+
+    DeviceTableFile file;
+    CHECK(file.Parse(data.data(), data.size()));
+    CHECK(file.HardwareIds.size() == 2 && file.InterfaceGuids.size() == 1);
+    CHECK(file.HardwareIds[0].VendorId == 0x045E && file.HardwareIds[0].ProductId == 0x028E &&
+        file.HardwareIds[0].Profile == 3);
+    CHECK(file.HardwareIds[1].VendorId == 0x1234 && file.HardwareIds[1].Profile == HardwareIdTable::RejectedProfile);
+    CHECK(file.InterfaceGuids[0] == guid);
+}
+
+static void TestParseMalformed()
+{
+    auto valid = MakeTable({ { 1, 2, 3 } }, {});
+    DeviceTableFile file;
+
+    auto badMagic = valid;
+    badMagic[0] = 'X';
+    CHECK(!file.Parse(badMagic.data(), badMagic.size()));
+
+    auto badVersion = valid;
+    badVersion[4] = 2;
+    CHECK(!file.Parse(badVersion.data(), badVersion.size()));
+
+    // A failed parse leaves nothing behind from an earlier one
+    CHECK(file.Parse(valid.data(), valid.size()) && file.HardwareIds.size() == 1);
+    CHECK(!file.Parse(valid.data(), DeviceTableFile::HeaderSize - 1));
+    CHECK(file.HardwareIds.empty());
+
+    // Counts describing more entries than the data holds, including ones that would overflow 32 bits
+    auto hardwareIdsPastEnd = MakeTable({ { 1, 2, 3 } }, {}, 2, 0);
+    CHECK(!file.Parse(hardwareIdsPastEnd.data(), hardwareIdsPastEnd.size()));
+    auto interfaceGuidsPastEnd = MakeTable({}, {}, 0, 1);
+    CHECK(!file.Parse(interfaceGuidsPastEnd.data(), interfaceGuidsPastEnd.size()));
+    auto hugeCounts = MakeTable({}, {}, 0xFFFFFFFF, 0xFFFFFFFF);
+    CHECK(!file.Parse(hugeCounts.data(), hugeCounts.size()));
+
+    // Only a header, with no entries
+    auto empty = MakeTable({}, {});
+    CHECK(empty.size() == DeviceTableFile::HeaderSize);
+    CHECK(file.Parse(empty.data(), empty.size()));
+    CHECK(file.HardwareIds.empty() && file.InterfaceGuids.empty());
+}
+
+static void TestLookups()
+{
+    HardwareIdTable table;
+    uint16_t profile = 99;
+    CHECK(!table.Find(1, 2, profile) && profile == 99);
+
+    table.Add({ 0x045E, 0x028E, 3 });
+    table.Add({ 0x045E, 0x0B12, 4 });
+    table.Add({ 0x0001, 0xFFFF, 5 });
+    CHECK(table.Size() == 3);
+    CHECK(table.Find(0x045E, 0x028E, profile) && profile == 3);
+    CHECK(table.Find(0x0001, 0xFFFF, profile) && profile == 5);
+    CHECK(!table.Find(0x045E, 0x028F, profile));
+    CHECK(!table.Find(0x0001, 0x0000, profile));
+
+    // Adding the same ID again replaces its profile rather than adding a second entry
+    table.Add({ 0x045E, 0x028E, 7 });
+    CHECK(table.Size() == 3);
+    CHECK(table.Find(0x045E, 0x028E, profile) && profile == 7);
+}
+
+static void TestAddRange()
+{
+    HardwareIdTable table;
+    table.Add({ 10, 1, 1 });
+    table.Add({ 30, 1, 1 });
+
+    // Duplicates within the range, and IDs that are already in the table
+    HardwareIdEntry entries[] = {
+        { 20, 1, 2 }, { 10, 1, 3 }, { 20, 1, 4 }, { 40, 1, 5 }, { 20, 1, 6 }, { 5, 1, 7 },
+    };
+    table.AddRange(entries, sizeof(entries) / sizeof(entries[0]));
+
+    uint16_t profile;
+    CHECK(table.Size() == 5);
+    CHECK(table.Find(5, 1, profile) && profile == 7);
+    CHECK(table.Find(10, 1, profile) && profile == 3);
+    CHECK(table.Find(20, 1, profile) && profile == 6);
+    CHECK(table.Find(30, 1, profile) && profile == 1);
+    CHECK(table.Find(40, 1, profile) && profile == 5);
+
+    table.AddRange(nullptr, 0);
+    CHECK(table.Size() == 5);
+}
+
+// AddRange must give the same table as adding each entry in turn
+static void TestAddRangeMatchesAdd()
+{
+    std::vector<HardwareIdEntry> entries;
+    uint32_t state = 12345;
+    for (int i = 0; i < 5000; i++)
+    {
+        state = state * 1103515245 + 12345;
+        entries.push_back({ static_cast<uint16_t>(state >> 24), static_cast<uint16_t>((state >> 16) & 0x3F),
+            static_cast<uint16_t>(i) });
+    }
+
+    HardwareIdTable one, bulk;
+    for (auto const& entry : entries)
+        one.Add(entry);
+    bulk.Add(entries[0]);
+    bulk.AddRange(entries.data(), entries.size());
+
+    CHECK(one.Size() == bulk.Size());
+    bool same = true;
+    for (uint32_t vendorId = 0; vendorId < 256; vendorId++)
+    {
+        for (uint16_t productId = 0; productId < 0x40; productId++)
+        {
+            uint16_t oneProfile = 0, bulkProfile = 0;
+            bool inOne = one.Find(static_cast<uint16_t>(vendorId), productId, oneProfile);
+            bool inBulk = bulk.Find(static_cast<uint16_t>(vendorId), productId, bulkProfile);
+            same = same && inOne == inBulk && oneProfile == bulkProfile;
+        }
+    }
+    CHECK(same);
+}
+
+static void Bench()
+{
+    constexpr size_t Count = 100000;
+    std::vector<HardwareIdEntry> entries(Count);
+    uint32_t state = 1;
+    for (size_t i = 0; i < Count; i++)
+    {
+        state = state * 1103515245 + 12345;
+        entries[i] = { static_cast<uint16_t>(state >> 16), static_cast<uint16_t>(i & 0x7FFF),
+            static_cast<uint16_t>(i % 8) };
+    }
+    auto data = MakeTable(entries, {});
+
+    // What DeviceTable.Register does with the file's contents, apart from registering each ID with the system
+    size_t size = 0;
+    double startupMs = TimePerCall(20, [&]
+    {
+        DeviceTableFile file;
+        file.Parse(data.data(), data.size());
+        HardwareIdTable table;
+        table.AddRange(file.HardwareIds.data(), file.HardwareIds.size());
+        size += table.Size();
+    }) / 1e6;
+
+    DeviceTableFile file;
+    file.Parse(data.data(), data.size());
+    HardwareIdTable table;
+    table.AddRange(file.HardwareIds.data(), file.HardwareIds.size());
+
+    size_t i = 0, found = 0;
+    double lookupNs = TimePerCall(1000000, [&]
+    {
+        auto const& entry = entries[(i++ * 7919) % Count];
+        uint16_t profile;
+        found += table.Find(entry.VendorId, entry.ProductId, profile);
+    });
+
+    double missNs = TimePerCall(1000000, [&]
+    {
+        uint16_t profile;
+        found += table.Find(static_cast<uint16_t>(i++), 0xFFFF, profile);
+    });
+
+    printf("%zu IDs: %.1f ms to parse and build, %.0f ns per lookup found, %.0f ns per lookup missed (%zu, %zu)\n",
+        Count, startupMs, lookupNs, missNs, size / 20, found);
+}
+
+int main(int argc, char** argv)
+{
+    TestParseValid();
+    TestParseMalformed();
+    TestLookups();
+    TestAddRange();
+    TestAddRangeMatchesAdd();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("HardwareIdTableTest");
+}
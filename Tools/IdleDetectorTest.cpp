@@ -0,0 +1,164 @@
+// Tests IdleDetector: how many unchanged reports make a device idle, the spacing of heartbeats while idle, a time
+// base going backwards, reconfiguring, turning detection off, and the skipped and idle period counts.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP IdleDetectorTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP IdleDetectorTest.cpp -o IdleDetectorTest
+//
+// Usage: IdleDetectorTest
+
+#include "Check.h"
+#include "WGIC/IdleDetector.h"
+
+using namespace winrt::WGIC::Core;
+
+// Feeds count unchanged reports 1 ms apart from timestamp onwards, returning how many were let through
+static int FeedUnchanged(IdleDetector& detector, uint64_t& timestamp, int count)
+{
+    int passed = 0;
+    for (int i = 0; i < count; i++)
+    {
+        timestamp += 1000;
+        passed += detector.Filter(timestamp, 0);
+    }
+    return passed;
+}
+
+static void TestThreshold()
+{
+    IdleDetector detector(4, 100000);
+    uint64_t timestamp = 0;
+    CHECK(detector.Filter(timestamp, 1));
+
+    // The first three unchanged reports still go through, and the fourth makes the device idle
+    CHECK(FeedUnchanged(detector, timestamp, 3) == 3);
+    CHECK(!detector.Idle());
+    CHECK(!detector.Filter(timestamp += 1000, 0));
+    CHECK(detector.Idle());
+    CHECK(detector.IdlePeriods() == 1 && detector.Skipped() == 1);
+
+    // Any changed byte ends idling and is let through
+    CHECK(detector.Filter(timestamp += 1000, 0x10));
+    CHECK(!detector.Idle());
+
+    // The count starts over
+    CHECK(FeedUnchanged(detector, timestamp, 3) == 3);
+    CHECK(!detector.Idle());
+}
+
+static void TestHeartbeat()
+{
+    IdleDetector detector(2, 10000);
+    uint64_t timestamp = 0;
+    detector.Filter(timestamp, 1);
+    FeedUnchanged(detector, timestamp, 2);
+    CHECK(detector.Idle());
+
+    // One unchanged report per 10 ms from the last one let through, which was at 1 ms
+    uint64_t skipped = detector.Skipped();
+    int passed = 0;
+    uint64_t lastPassed = 1000;
+    bool spaced = true;
+    for (int i = 0; i < 100; i++)
+    {
+        timestamp += 1000;
+        if (detector.Filter(timestamp, 0))
+        {
+            spaced = spaced && timestamp - lastPassed == 10000;
+            lastPassed = timestamp;
+            passed++;
+        }
+    }
+    CHECK(spaced);
+    CHECK(passed == 10);
+    CHECK(detector.Skipped() == skipped + 90);
+    CHECK(detector.Idle() && detector.IdlePeriods() == 1);
+
+    // Uneven spacing: a heartbeat is due once the interval has passed, not on a fixed grid
+    CHECK(!detector.Filter(lastPassed + 9999, 0));
+    CHECK(detector.Filter(lastPassed + 10500, 0));
+    CHECK(!detector.Filter(lastPassed + 20000, 0));
+    CHECK(detector.Filter(lastPassed + 20500, 0));
+}
+
+static void TestTimestampBackwards()
+{
+    IdleDetector detector(2, 100000);
+    uint64_t timestamp = 5000000;
+    detector.Filter(timestamp, 1);
+    FeedUnchanged(detector, timestamp, 3);
+    CHECK(detector.Idle());
+
+    // The device's time base was reset, so the report goes through rather than waiting for the old time to come round
+    CHECK(detector.Filter(2000, 0));
+    CHECK(!detector.Filter(3000, 0));
+    CHECK(detector.Filter(102000, 0));
+    CHECK(detector.Idle());
+}
+
+static void TestConfigure()
+{
+    IdleDetector detector(2, 100000);
+    uint64_t timestamp = 0;
+    detector.Filter(timestamp, 1);
+    FeedUnchanged(detector, timestamp, 5);
+    CHECK(detector.Idle());
+    uint64_t skipped = detector.Skipped();
+    CHECK(skipped == 4 && detector.IdlePeriods() == 1);
+
+    // Active again until the new count of unchanged reports, with the counters kept
+    detector.Configure(3, 50000);
+    CHECK(!detector.Idle());
+    CHECK(detector.Skipped() == skipped && detector.IdlePeriods() == 1);
+    CHECK(FeedUnchanged(detector, timestamp, 2) == 2);
+    CHECK(!detector.Filter(timestamp += 1000, 0));
+    CHECK(detector.Idle() && detector.IdlePeriods() == 2 && detector.Skipped() == skipped + 1);
+}
+
+static void TestDisabled()
+{
+    IdleDetector detector(0, 100000);
+    uint64_t timestamp = 0;
+    CHECK(FeedUnchanged(detector, timestamp, 1000) == 1000);
+    CHECK(!detector.Idle() && detector.Skipped() == 0 && detector.IdlePeriods() == 0);
+
+    // Turning it off while idle lets everything through from then on
+    IdleDetector idle(2, 100000);
+    idle.Filter(timestamp, 1);
+    FeedUnchanged(idle, timestamp, 10);
+    CHECK(idle.Idle());
+    idle.Configure(0, 100000);
+    CHECK(FeedUnchanged(idle, timestamp, 10) == 10);
+    CHECK(!idle.Idle());
+}
+
+// A pad held still for a second at a time, with a 50 ms press between, as in the measurements when this was added
+static void TestAccounting()
+{
+    IdleDetector detector;
+    uint64_t timestamp = 0;
+    uint64_t passed = 0, total = 0;
+    for (int second = 0; second < 5; second++)
+    {
+        for (int ms = 0; ms < 1000; ms++, total++)
+        {
+            timestamp += 1000;
+            // A change as the button goes down and as it comes up
+            uint64_t changeMask = ms == 0 || ms == 50 ? 1 : 0;
+            passed += detector.Filter(timestamp, changeMask);
+        }
+    }
+
+    CHECK(passed + detector.Skipped() == total);
+    CHECK(detector.IdlePeriods() == 10);
+    CHECK(passed < total / 10);
+}
+
+int main()
+{
+    TestThreshold();
+    TestHeartbeat();
+    TestTimestampBackwards();
+    TestConfigure();
+    TestDisabled();
+    TestAccounting();
+    return CheckResult("IdleDetectorTest");
+}
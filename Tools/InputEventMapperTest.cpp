@@ -0,0 +1,177 @@
+// Tests InputMap and EventMapper, which turn reports into button, axis and hat events.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP InputEventMapperTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP InputEventMapperTest.cpp -o InputEventMapperTest
+//
+// Usage: InputEventMapperTest
+
+#include <vector>
+#include "Check.h"
+#include "WGIC/InputEventMapper.h"
+#include "WGIC/ReportDiff.h"
+
+using namespace winrt::WGIC::Core;
+
+static ControlMapping Button(uint16_t offset, uint8_t bit, uint8_t control)
+{
+    return { ControlType::Button, 0, offset, bit, 0, false, 0, control, ControlTransform::None };
+}
+
+static ControlMapping Axis(uint16_t offset, uint8_t size, int32_t threshold, uint8_t control)
+{
+    return { ControlType::Axis, 0, offset, 0, size, false, threshold, control, ControlTransform::None };
+}
+
+// Feeds reports to a mapper the way CustomDevice does, with the change mask against the previous report
+class Feeder
+{
+private:
+    std::vector<uint8_t> m_previous;
+    uint64_t m_timestamp = 0;
+
+public:
+    EventMapper Mapper;
+    EventQueue Queue { 64 };
+
+    explicit Feeder(MappingList mappings)
+        : Mapper(std::make_shared<const InputMap>(std::move(mappings)))
+    {
+    }
+
+    std::vector<InputEvent> Feed(std::vector<uint8_t> const& report)
+    {
+        uint64_t changeMask = ReportChangeMask(m_previous.data(), m_previous.size(), report.data(), report.size());
+        Mapper.Process(++m_timestamp, 0, report.data(), report.size(), changeMask, Queue);
+        m_previous = report;
+
+        std::vector<InputEvent> events(Queue.Size());
+        events.resize(Queue.Drain(events.data(), events.size()));
+        return events;
+    }
+};
+
+static void TestButtons()
+{
+    Feeder feeder({ Button(1, 2, 5) });
+    CHECK(feeder.Feed({ 0, 0, 0 }).empty()); // Baseline
+
+    auto events = feeder.Feed({ 0, 0x04, 0 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::ButtonPressed && events[0].Control == 5);
+
+    CHECK(feeder.Feed({ 0xFF, 0x04, 0xFF }).empty());
+
+    events = feeder.Feed({ 0, 0, 0 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::ButtonReleased);
+}
+
+// A bit index past the first byte reads from a later byte, and changes there are noticed
+static void TestButtonBitPastFirstByte()
+{
+    Feeder feeder({ Button(1, 11, 0), Button(0, 8, 1) });
+    CHECK(feeder.Feed({ 0, 0, 0, 0 }).empty());
+
+    // Bit 11 from byte 1 is bit 3 of byte 2
+    auto events = feeder.Feed({ 0, 0, 0x08, 0 });
+    CHECK(events.size() == 1 && events[0].Control == 0 && events[0].Type == EventType::ButtonPressed);
+
+    // Bit 3 of byte 1, which the button used to be read from, doesn't affect it
+    CHECK(feeder.Feed({ 0, 0x08, 0x08, 0 }).empty());
+
+    events = feeder.Feed({ 0, 0x09, 0x08, 0 });
+    CHECK(events.size() == 1 && events[0].Control == 1);
+
+    // A bit past the end of the report is never read
+    Feeder outside({ Button(2, 16, 0) });
+    outside.Feed({ 0, 0, 0 });
+    CHECK(outside.Feed({ 0xFF, 0xFF, 0xFF }).empty());
+}
+
+static void TestHatBitPastFirstByte()
+{
+    ControlMapping hat { ControlType::Hat, 0, 0, 12, 4, false, 0, 0, ControlTransform::None };
+    InputMap map({ hat });
+    CHECK(map.Size() == 1 && map[0].Offset == 1 && map[0].Bit == 4);
+
+    Feeder feeder({ hat });
+    feeder.Feed({ 0, 0 });
+    auto events = feeder.Feed({ 0, 0x70 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::HatChanged && events[0].Value == 7);
+}
+
+static void TestAxisThreshold()
+{
+    Feeder feeder({ Axis(0, 2, 1000, 3) });
+    feeder.Feed({ 0, 0 });
+
+    auto events = feeder.Feed({ 0xE8, 0x03 }); // 1000
+    CHECK(events.size() == 1 && events[0].Type == EventType::AxisAboveThreshold && events[0].Value == 1000);
+
+    CHECK(feeder.Feed({ 0xE9, 0x03 }).empty());
+
+    events = feeder.Feed({ 0, 0 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::AxisBelowThreshold);
+}
+
+// Switching maps while a button is held: the new mapper reads the held button from the next report, even though
+// nothing in it changed, and sees it released afterwards
+static void TestMapSwitchWhileHeld()
+{
+    Feeder feeder({ Button(0, 0, 0), Axis(1, 1, 100, 0) });
+    feeder.Feed({ 0, 0 });
+    feeder.Feed({ 1, 200 });
+
+    // As CustomDevice::RefreshInputMap does when a map is registered for the device
+    feeder.Mapper = EventMapper(std::make_shared<const InputMap>(MappingList { Button(0, 0, 4), Axis(1, 1, 100, 2) }));
+
+    CHECK(feeder.Feed({ 1, 200 }).empty());
+    uint64_t buttons = 0;
+    int32_t axes[8] = {};
+    uint8_t hats[4] = {};
+    feeder.Mapper.WriteState(buttons, axes, 8, hats, 4);
+    CHECK(buttons == 1ull << 4);
+    CHECK(axes[2] == 200);
+
+    auto events = feeder.Feed({ 0, 50 });
+    CHECK(events.size() == 2 && events[0].Type == EventType::ButtonReleased && events[0].Control == 4);
+    CHECK(events.size() == 2 && events[1].Type == EventType::AxisBelowThreshold && events[1].Control == 2);
+
+    // Once every control has a baseline, unchanged reports are skipped again
+    CHECK(feeder.Feed({ 0, 50 }).empty());
+}
+
+// A control past the end of the reports the device sends mustn't keep every unchanged report being read
+static void TestControlPastReportEnd()
+{
+    Feeder feeder({ Button(0, 0, 0), Axis(4, 2, 100, 1) });
+    CHECK(!feeder.Mapper.Baselined());
+    CHECK(feeder.Feed({ 0, 0 }).empty());
+    CHECK(feeder.Mapper.Baselined());
+
+    uint64_t buttons = 0;
+    int32_t axes[8] = { -1, -1 };
+    uint8_t hats[4] = {};
+    feeder.Mapper.WriteState(buttons, axes, 8, hats, 4);
+    CHECK(axes[1] == -1);
+
+    auto events = feeder.Feed({ 1, 0 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::ButtonPressed);
+
+    // A longer report sets the axis's baseline rather than generating an event from a value it never had
+    CHECK(feeder.Feed({ 1, 0, 0, 0, 0xC8, 0 }).empty());
+    feeder.Mapper.WriteState(buttons, axes, 8, hats, 4);
+    CHECK(axes[1] == 200);
+
+    events = feeder.Feed({ 1, 0, 0, 0, 0x10, 0 });
+    CHECK(events.size() == 1 && events[0].Type == EventType::AxisBelowThreshold && events[0].Control == 1);
+    CHECK(feeder.Mapper.Baselined());
+}
+
+int main()
+{
+    TestButtons();
+    TestButtonBitPastFirstByte();
+    TestHatBitPastFirstByte();
+    TestAxisThreshold();
+    TestMapSwitchWhileHeld();
+    TestControlPastReportEnd();
+    return CheckResult("InputEventMapperTest");
+}
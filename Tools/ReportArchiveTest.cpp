@@ -0,0 +1,107 @@
+// Tests ReportArchive, the delta-encoded long-term report history, and the budget shared by archives.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP ReportArchiveTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP ReportArchiveTest.cpp -o ReportArchiveTest
+//
+// Usage: ReportArchiveTest
+
+#include <vector>
+#include "Check.h"
+#include "WGIC/ReportArchive.h"
+
+using namespace winrt::WGIC::Core;
+
+struct Report
+{
+    uint64_t Timestamp;
+    uint8_t ReportId;
+    std::vector<uint8_t> Data;
+};
+
+static std::vector<Report> ReadAll(ReportArchive const& archive, uint64_t from = 0, uint64_t to = UINT64_MAX)
+{
+    std::vector<Report> reports;
+    archive.ForEach(from, to, [&](uint64_t timestamp, uint8_t reportId, const uint8_t* data, size_t length)
+    {
+        reports.push_back({ timestamp, reportId, std::vector<uint8_t>(data, data + length) });
+        return true;
+    });
+    return reports;
+}
+
+static void TestRoundTrip()
+{
+    auto archive = ReportArchive::Create(std::make_shared<ArchiveBudget>(UINT64_MAX), 4);
+    std::vector<Report> appended;
+    for (uint64_t i = 0; i < 10; i++)
+    {
+        // Changing length and report ID partway through
+        std::vector<uint8_t> data(i < 6 ? 8 : 5, 0);
+        data[i % data.size()] = static_cast<uint8_t>(i);
+        uint8_t reportId = i < 3 ? 1 : 2;
+        archive->Append(1000 + i * 10, reportId, data.data(), data.size());
+        appended.push_back({ 1000 + i * 10, reportId, data });
+    }
+
+    auto reports = ReadAll(*archive);
+    bool same = reports.size() == appended.size();
+    for (size_t i = 0; same && i < reports.size(); i++)
+    {
+        same = reports[i].Timestamp == appended[i].Timestamp && reports[i].ReportId == appended[i].ReportId &&
+            reports[i].Data == appended[i].Data;
+    }
+    CHECK(same);
+
+    reports = ReadAll(*archive, 1025, 1055);
+    CHECK(reports.size() == 3 && reports[0].Timestamp == 1030 && reports[2].Timestamp == 1050);
+}
+
+// A timestamp going backwards discards the archive, including right after a block was sealed, when the active
+// block is still empty
+static void TestBackwardsAfterSeal()
+{
+    auto archive = ReportArchive::Create(std::make_shared<ArchiveBudget>(UINT64_MAX), 4);
+    uint8_t data[4] = {};
+    for (uint64_t i = 0; i < 4; i++)
+        archive->Append(5000 + i, 1, data, sizeof(data));
+
+    archive->Append(10, 1, data, sizeof(data));
+    auto reports = ReadAll(*archive);
+    CHECK(reports.size() == 1 && reports[0].Timestamp == 10);
+
+    // And within a block
+    archive->Append(20, 1, data, sizeof(data));
+    archive->Append(15, 1, data, sizeof(data));
+    reports = ReadAll(*archive);
+    CHECK(reports.size() == 1 && reports[0].Timestamp == 15);
+}
+
+static void TestBudget()
+{
+    auto budget = std::make_shared<ArchiveBudget>(UINT64_MAX);
+    auto archive = ReportArchive::Create(budget, 8);
+    std::vector<uint8_t> data(32);
+    for (uint64_t i = 0; i < 64; i++)
+    {
+        data[i % 32]++;
+        archive->Append(i, 1, data.data(), data.size());
+    }
+    CHECK(budget->Used() == archive->Size());
+
+    // Only whole blocks are evicted, oldest first
+    budget->SetLimit(archive->Size() / 2);
+    CHECK(budget->Used() <= budget->Limit());
+    CHECK(budget->EvictedBlocks() > 0);
+    auto reports = ReadAll(*archive);
+    CHECK(!reports.empty() && reports.back().Timestamp == 63 && reports.front().Timestamp % 8 == 0);
+
+    archive.reset();
+    CHECK(budget->Used() == 0);
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestBackwardsAfterSeal();
+    TestBudget();
+    return CheckResult("ReportArchiveTest");
+}
@@ -0,0 +1,130 @@
+// Checks ReportChangeMask against a byte-by-byte reference, for both the SSE2 and the portable version, and with
+// --bench measures them on reports of 8 to 64 bytes.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP ReportDiffTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP ReportDiffTest.cpp -o ReportDiffTest
+//
+// Usage: ReportDiffTest [--bench]
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Check.h"
+#include "WGIC/ReportDiff.h"
+
+using namespace winrt::WGIC::Core;
+
+static uint64_t ReferenceMask(const uint8_t* previous, const uint8_t* current, size_t length)
+{
+    uint64_t mask = 0;
+    for (size_t i = 0; i < length; i++)
+    {
+        if (previous[i] != current[i])
+            mask |= 1ull << (i < 63 ? i : 63);
+    }
+    return mask;
+}
+
+static void TestAgainstReference()
+{
+    std::mt19937 random(1);
+    std::vector<uint8_t> previous(200), current(200);
+    bool scalarMatches = true;
+    bool sse2Matches = true;
+    for (int round = 0; round < 20000; round++)
+    {
+        size_t length = random() % 160;
+        for (size_t i = 0; i < length; i++)
+            previous[i] = current[i] = static_cast<uint8_t>(random());
+
+        // Anywhere from no changes to every byte changing
+        size_t changes = random() % 4 == 0 ? 0 : random() % (length + 1);
+        for (size_t i = 0; i < changes; i++)
+            current[random() % length]++;
+
+        uint64_t expected = ReferenceMask(previous.data(), current.data(), length);
+        scalarMatches &= ReportChangeMaskScalar(previous.data(), current.data(), length) == expected;
+#ifdef WGIC_REPORT_DIFF_SSE2
+        sse2Matches &= ReportChangeMaskSse2(previous.data(), current.data(), length) == expected;
+#endif
+        CHECK(ReportChangeMask(previous.data(), length, current.data(), length) == expected);
+    }
+
+    CHECK(scalarMatches);
+    CHECK(sse2Matches);
+}
+
+static void TestEdges()
+{
+    uint8_t a[100] = {};
+    uint8_t b[100] = {};
+    CHECK(ReportChangeMask(a, 0, b, 0) == 0);
+    CHECK(ReportChangeMask(a, 3, b, 4) == ~0ull);
+
+    b[0] = 1;
+    b[15] = 1;
+    b[16] = 1;
+    CHECK(ReportChangeMask(a, 64, b, 64) == ((1ull << 0) | (1ull << 15) | (1ull << 16)));
+
+    // Everything from byte 63 on folds into bit 63
+    uint8_t c[100] = {};
+    c[99] = 1;
+    CHECK(ReportChangeMask(a, 100, c, 100) == 1ull << 63);
+    c[99] = 0;
+    c[63] = 1;
+    CHECK(ReportChangeMask(a, 100, c, 100) == 1ull << 63);
+}
+
+// Runs mask over a stream of consecutive reports, as a sink sees them, where each report changes one byte of the
+// previous one or none
+template<typename TMask>
+static double Measure(TMask&& mask, size_t length, bool changed, uint64_t& sum)
+{
+    constexpr size_t ReportCount = 1024;
+    std::vector<uint8_t> reports(ReportCount * length);
+    for (size_t report = 1; report < ReportCount; report++)
+    {
+        memcpy(&reports[report * length], &reports[(report - 1) * length], length);
+        if (changed)
+            reports[report * length + report * 7 % length]++;
+    }
+
+    size_t report = 0;
+    return TimePerCall(10000000, [&]
+    {
+        report = report + 1 < ReportCount ? report + 1 : 1;
+        sum += mask(&reports[(report - 1) * length], &reports[report * length], length);
+    });
+}
+
+static void Bench()
+{
+    uint64_t sum = 0;
+    printf("ns per call   length  reference  portable  SSE2\n");
+    for (size_t length : { 8, 16, 32, 48, 64 })
+    {
+        for (bool changed : { false, true })
+        {
+            double reference = Measure(ReferenceMask, length, changed, sum);
+            double scalar = Measure(ReportChangeMaskScalar, length, changed, sum);
+#ifdef WGIC_REPORT_DIFF_SSE2
+            double sse2 = Measure(ReportChangeMaskSse2, length, changed, sum);
+#else
+            double sse2 = 0;
+#endif
+            printf("%-13s %6zu  %9.2f  %8.2f  %4.2f\n", changed ? "1 changed" : "identical", length, reference, scalar, sse2);
+        }
+    }
+    printf("(checksum %llu)\n", static_cast<unsigned long long>(sum));
+}
+
+int main(int argc, char** argv)
+{
+    TestAgainstReference();
+    TestEdges();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("ReportDiffTest");
+}
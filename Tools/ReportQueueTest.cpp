@@ -0,0 +1,136 @@
+// Tests ReportQueue, which hands a device's reports from its input sink to the worker pool: ordering, and detaching
+// from another thread or from within the handler itself.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP ReportQueueTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP ReportQueueTest.cpp -o ReportQueueTest
+//
+// Usage: ReportQueueTest
+
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Check.h"
+#include "WGIC/ReportQueue.h"
+
+using namespace winrt::WGIC::Core;
+using namespace std::chrono_literals;
+
+// Polls until condition holds, or gives up after a second
+template<typename TCondition>
+static bool WaitFor(TCondition&& condition)
+{
+    for (int i = 0; i < 200 && !condition(); i++)
+        std::this_thread::sleep_for(5ms);
+    return condition();
+}
+
+static void Push(ReportQueue& queue, uint64_t timestamp)
+{
+    uint8_t data[4] = { static_cast<uint8_t>(timestamp), 0, 0, 0 };
+    QueuedReport report { timestamp, 0, 0, 0, 0, sizeof(data), 1, 0, 0 };
+    queue.Push(report, data);
+}
+
+// Stands in for a device, which detaches its queue when destroyed
+struct Device
+{
+    std::shared_ptr<ReportQueue> Queue;
+    std::vector<uint64_t> Processed;
+    std::atomic<size_t> ProcessedCount { 0 };
+    std::shared_ptr<Device>* LastReference = nullptr;
+    uint64_t ReleaseAt = UINT64_MAX;
+    std::atomic<bool>* Destroyed = nullptr;
+
+    explicit Device(WorkerPool& pool)
+    {
+        Queue = std::make_shared<ReportQueue>(pool, 64 * 1024, [this](ReportQueue& queue) { Process(queue); });
+    }
+
+    ~Device()
+    {
+        Queue->Detach();
+        if (Destroyed)
+            *Destroyed = true;
+    }
+
+    void Process(ReportQueue& queue)
+    {
+        QueuedReport report;
+        const uint8_t* data;
+        bool release = false;
+        while (queue.Front(report, data))
+        {
+            CHECK(data[0] == static_cast<uint8_t>(report.Timestamp));
+            Processed.push_back(report.Timestamp);
+            release |= report.Timestamp == ReleaseAt;
+            queue.Pop();
+        }
+        ProcessedCount.store(Processed.size());
+
+        // As when a waiter resumed by the device's report signal drops the last reference to it
+        if (release)
+            LastReference->reset();
+    }
+};
+
+static void TestInOrder()
+{
+    WorkerPool pool(4);
+    Device device(pool);
+    for (uint64_t i = 0; i < 1000; i++)
+        Push(*device.Queue, i);
+
+    CHECK(WaitFor([&] { return device.ProcessedCount.load() == 1000; }));
+    for (uint64_t i = 0; i < device.Processed.size(); i++)
+        CHECK(device.Processed[i] == i);
+}
+
+static void TestDetachFromHandler()
+{
+    WorkerPool pool(2);
+    auto device = std::make_shared<Device>(pool);
+    std::shared_ptr<ReportQueue> queue = device->Queue;
+    device->LastReference = &device;
+    device->ReleaseAt = 3;
+    std::atomic<bool> destroyed { false };
+    device->Destroyed = &destroyed;
+
+    // Used to deadlock, with the handler waiting in Detach for itself to return
+    for (uint64_t i = 0; i < 4; i++)
+        Push(*queue, i);
+    CHECK(WaitFor([&] { return destroyed.load(); }));
+
+    // Reports pushed after detaching are discarded rather than handed to the destroyed device
+    for (uint64_t i = 4; i < 8; i++)
+        Push(*queue, i);
+    CHECK(WaitFor([&] { return queue.use_count() == 1; }));
+}
+
+static void TestDetachWaitsForHandler()
+{
+    WorkerPool pool(2);
+    std::atomic<bool> running { false };
+    std::atomic<bool> returned { false };
+    auto queue = std::make_shared<ReportQueue>(pool, 4096, [&](ReportQueue& queue)
+    {
+        running = true;
+        std::this_thread::sleep_for(50ms);
+        QueuedReport report;
+        const uint8_t* data;
+        while (queue.Front(report, data))
+            queue.Pop();
+        returned = true;
+    });
+
+    Push(*queue, 1);
+    CHECK(WaitFor([&] { return running.load(); }));
+    queue->Detach();
+    CHECK(returned);
+}
+
+int main()
+{
+    TestInOrder();
+    TestDetachFromHandler();
+    TestDetachWaitsForHandler();
+    return CheckResult("ReportQueueTest");
+}
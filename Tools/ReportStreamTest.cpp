@@ -0,0 +1,103 @@
+// Tests StreamServer and StreamClient over a local socket: listening next to a live or stale server, streaming
+// frames, and dropping clients that disconnect.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP ReportStreamTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP ReportStreamTest.cpp -o ReportStreamTest
+//
+// Usage: ReportStreamTest
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include "Check.h"
+#include "WGIC/ReportStream.h"
+
+using namespace winrt::WGIC::Core;
+using namespace std::chrono_literals;
+
+static std::string TestPath(const char* name)
+{
+#ifdef _WIN32
+    return std::string(getenv("TEMP")) + "\\" + name;
+#else
+    return std::string("/tmp/") + name + "." + std::to_string(getpid());
+#endif
+}
+
+// Polls until condition holds, or gives up after a second
+template<typename TCondition>
+static bool WaitFor(TCondition&& condition)
+{
+    for (int i = 0; i < 200 && !condition(); i++)
+        std::this_thread::sleep_for(5ms);
+    return condition();
+}
+
+static void TestSecondServerLeavesFirstAlone()
+{
+    std::string path = TestPath("wgic-stream-live");
+    StreamServer first(path, 5ms, 64 * 1024);
+    CHECK(first.Start());
+
+    // Used to unlink the first server's socket file and take the path over
+    StreamServer second(path, 5ms, 64 * 1024);
+    CHECK(!second.Start());
+
+    StreamClient client;
+    CHECK(client.Connect(path));
+    CHECK(WaitFor([&] { return first.ClientCount() == 1; }));
+
+    ReportRecord record {};
+    record.Timestamp = 42;
+    uint8_t data[3] = { 1, 2, 3 };
+    first.Publish(record, data, sizeof(data));
+    CHECK(client.ReadFrame());
+    CHECK(client.Header().RecordCount == 1);
+    client.ForEachRecord([&](ReportRecord const& received, const uint8_t* receivedData)
+    {
+        CHECK(received.Timestamp == 42 && received.Length == 3 && receivedData[2] == 3);
+    });
+}
+
+static void TestStaleSocketFileReplaced()
+{
+    std::string path = TestPath("wgic-stream-stale");
+    {
+        // A listener that goes away without removing its socket file, as after a crash
+        LocalSocket stale;
+        CHECK(stale.Listen(path));
+    }
+    CHECK(!LocalSocket::InUse(path));
+
+    StreamServer server(path, 5ms, 64 * 1024);
+    CHECK(server.Start());
+    StreamClient client;
+    CHECK(client.Connect(path));
+}
+
+static void TestDisconnectedClientsDropped()
+{
+    std::string path = TestPath("wgic-stream-drop");
+    StreamServer server(path, 5ms, 64 * 1024);
+    CHECK(server.Start());
+
+    StreamClient clients[3];
+    for (auto& client : clients)
+        CHECK(client.Connect(path));
+    CHECK(WaitFor([&] { return server.ClientCount() == 3; }));
+
+    // Nothing is published, so there's never a failed send to notice them by
+    clients[0].Close();
+    clients[2].Close();
+    CHECK(WaitFor([&] { return server.ClientCount() == 1; }));
+
+    clients[1].Close();
+    CHECK(WaitFor([&] { return server.ClientCount() == 0; }));
+}
+
+int main()
+{
+    TestSecondServerLeavesFirstAlone();
+    TestStaleSocketFileReplaced();
+    TestDisconnectedClientsDropped();
+    return CheckResult("ReportStreamTest");
+}
@@ -0,0 +1,246 @@
+// Tests StateHistory, the per-device ring of control states indexed by report timestamp: lookups, ranges that wrap
+// around the ring, retention and a time base going backwards, and lookups racing a writer, which must never return a
+// torn state. With --bench it measures lookup and range cost with and without a writer appending at the same time.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP StateHistoryTest.cpp
+//   g++ -std=c++17 -O2 -pthread -I../UWP_CPP StateHistoryTest.cpp -o StateHistoryTest
+//
+// Usage: StateHistoryTest [--bench]
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include "Check.h"
+#include "WGIC/StateHistory.h"
+
+using namespace winrt::WGIC::Core;
+
+// Every field follows from the timestamp, so a state mixed from two entries shows up
+static ControlState MakeState(uint64_t timestamp)
+{
+    ControlState state {};
+    state.Buttons = timestamp;
+    for (size_t i = 0; i < AxesPerDevice; i++)
+        state.Axes[i] = static_cast<int32_t>(timestamp * (i + 1));
+    for (size_t i = 0; i < HatsPerDevice; i++)
+        state.Hats[i] = static_cast<uint8_t>(timestamp + i);
+    return state;
+}
+
+static bool Matches(uint64_t timestamp, ControlState const& state)
+{
+    ControlState expected = MakeState(timestamp);
+    return state.Buttons == expected.Buttons && memcmp(state.Axes, expected.Axes, sizeof(state.Axes)) == 0 &&
+        memcmp(state.Hats, expected.Hats, sizeof(state.Hats)) == 0;
+}
+
+static void TestLookups()
+{
+    StateHistory history(8, UINT64_MAX);
+    uint64_t entryTimestamp;
+    ControlState state;
+    CHECK(!history.StateAt(100, entryTimestamp, state));
+
+    for (uint64_t timestamp = 10; timestamp <= 50; timestamp += 10)
+        history.Append(timestamp, MakeState(timestamp));
+
+    CHECK(history.StateAt(30, entryTimestamp, state) && entryTimestamp == 30 && Matches(30, state));
+    CHECK(history.StateAt(39, entryTimestamp, state) && entryTimestamp == 30);
+    CHECK(history.StateAt(UINT64_MAX, entryTimestamp, state) && entryTimestamp == 50);
+    CHECK(!history.StateAt(9, entryTimestamp, state));
+
+    HistorySpan spans[2];
+    uint64_t token;
+    CHECK(history.Range(15, 45, spans, token) == 3);
+    CHECK(spans[0].Count == 3 && spans[0].Timestamps[0] == 20 && spans[0].Timestamps[2] == 40 && spans[1].Count == 0);
+    CHECK(history.StillValid(token));
+    CHECK(history.Range(51, 60, spans, token) == 0);
+    CHECK(history.Range(40, 20, spans, token) == 0);
+}
+
+static void TestWrapAround()
+{
+    StateHistory history(8, UINT64_MAX);
+    for (uint64_t timestamp = 1; timestamp <= 13; timestamp++)
+        history.Append(timestamp, MakeState(timestamp));
+
+    // The slot after the newest entry may be mid-write, so only the newest 7 of 8 are readable
+    uint64_t entryTimestamp;
+    ControlState state;
+    CHECK(!history.StateAt(6, entryTimestamp, state));
+    CHECK(history.StateAt(7, entryTimestamp, state) && entryTimestamp == 7);
+
+    HistorySpan spans[2];
+    uint64_t token;
+    CHECK(history.Range(0, UINT64_MAX, spans, token) == 7);
+    CHECK(spans[0].Count + spans[1].Count == 7 && spans[1].Count > 0);
+    uint64_t expected = 7;
+    for (auto const& span : spans)
+    {
+        for (size_t i = 0; i < span.Count; i++, expected++)
+            CHECK(span.Timestamps[i] == expected && Matches(expected, span.States[i]));
+    }
+    CHECK(history.StillValid(token));
+
+    // Eight more appends overwrite everything the range pointed at
+    for (uint64_t timestamp = 14; timestamp <= 21; timestamp++)
+        history.Append(timestamp, MakeState(timestamp));
+    CHECK(!history.StillValid(token));
+}
+
+static void TestRetentionAndReset()
+{
+    StateHistory history(16, 25);
+    for (uint64_t timestamp = 10; timestamp <= 100; timestamp += 10)
+        history.Append(timestamp, MakeState(timestamp));
+
+    // Only entries within 25 of the newest are kept
+    uint64_t entryTimestamp;
+    ControlState state;
+    CHECK(!history.StateAt(70, entryTimestamp, state));
+    CHECK(history.StateAt(80, entryTimestamp, state) && entryTimestamp == 80);
+
+    // A time base going backwards starts the history over
+    history.Append(5, MakeState(5));
+    CHECK(history.StateAt(100, entryTimestamp, state) && entryTimestamp == 5 && Matches(5, state));
+}
+
+// Reads race a writer appending as fast as it can to a small ring, which overwrites entries while they're being read
+static void TestConcurrentReads()
+{
+    StateHistory history(64, UINT64_MAX);
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> newest { 0 };
+    std::thread writer([&]
+    {
+        for (uint64_t timestamp = 1; !stop; timestamp++)
+        {
+            history.Append(timestamp, MakeState(timestamp));
+            newest.store(timestamp, std::memory_order_relaxed);
+            if (timestamp % 64 == 0)
+                std::this_thread::yield();
+        }
+    });
+
+    while (newest.load() < 128)
+        std::this_thread::yield();
+
+    uint64_t torn = 0, found = 0, ranges = 0, invalidated = 0;
+    for (uint64_t i = 0; i < 200000; i++)
+    {
+        uint64_t query = newest.load(std::memory_order_relaxed) - i % 80;
+        uint64_t entryTimestamp;
+        ControlState state;
+        if (history.StateAt(query, entryTimestamp, state))
+        {
+            found++;
+            if (entryTimestamp > query || !Matches(entryTimestamp, state))
+                torn++;
+        }
+
+        HistorySpan spans[2];
+        uint64_t token;
+        ControlState copies[64];
+        uint64_t timestamps[64];
+        size_t count = 0;
+        if (history.Range(query - 20, query, spans, token) == 0)
+            continue;
+
+        for (auto const& span : spans)
+        {
+            for (size_t j = 0; j < span.Count && count < 64; j++, count++)
+            {
+                timestamps[count] = span.Timestamps[j];
+                copies[count] = span.States[j];
+            }
+        }
+
+        if (!history.StillValid(token))
+        {
+            invalidated++;
+            continue;
+        }
+
+        ranges++;
+        for (size_t j = 0; j < count; j++)
+        {
+            if (!Matches(timestamps[j], copies[j]) || timestamps[j] + 20 < query || timestamps[j] > query ||
+                (j > 0 && timestamps[j] != timestamps[j - 1] + 1))
+            {
+                torn++;
+            }
+        }
+    }
+
+    stop = true;
+    writer.join();
+    CHECK(torn == 0);
+    CHECK(found > 0 && ranges > 0);
+    printf("Concurrent: %llu lookups found, %llu ranges read, %llu ranges overwritten while reading\n",
+        static_cast<unsigned long long>(found), static_cast<unsigned long long>(ranges),
+        static_cast<unsigned long long>(invalidated));
+}
+
+static void Bench()
+{
+    constexpr size_t Capacity = 4096;
+    StateHistory history(Capacity, UINT64_MAX);
+    uint64_t timestamp = 0;
+    for (; timestamp < Capacity; timestamp++)
+        history.Append(timestamp * 1000, MakeState(timestamp));
+
+    uint64_t sum = 0;
+    uint64_t i = 0;
+    auto lookup = [&]
+    {
+        uint64_t entryTimestamp;
+        ControlState state;
+        if (history.StateAt((timestamp - 1 - (i++ * 7919) % (Capacity / 2)) * 1000, entryTimestamp, state))
+            sum += state.Buttons;
+    };
+    auto range = [&]
+    {
+        HistorySpan spans[2];
+        uint64_t token;
+        uint64_t to = (timestamp - 1 - (i++ * 7919) % (Capacity / 2)) * 1000;
+        sum += history.Range(to - 63 * 1000, to, spans, token);
+        sum += history.StillValid(token);
+    };
+
+    double idleLookupNs = TimePerCall(1000000, lookup);
+    double idleRangeNs = TimePerCall(1000000, range);
+
+    // Appending at 1000 Hz or faster, as a device reporting continuously would
+    std::atomic<bool> stop { false };
+    std::atomic<uint64_t> appended { 0 };
+    std::thread writer([&]
+    {
+        for (uint64_t next = timestamp; !stop; next++)
+        {
+            history.Append(next * 1000, MakeState(next));
+            appended++;
+            std::this_thread::yield();
+        }
+    });
+
+    double busyLookupNs = TimePerCall(1000000, lookup);
+    double busyRangeNs = TimePerCall(1000000, range);
+    stop = true;
+    writer.join();
+
+    printf("StateAt %.0f ns, 64-entry Range %.0f ns; with a writer appending (%llu appends) StateAt %.0f ns, "
+        "Range %.0f ns (checksum %llu)\n", idleLookupNs, idleRangeNs, static_cast<unsigned long long>(appended.load()),
+        busyLookupNs, busyRangeNs, static_cast<unsigned long long>(sum));
+}
+
+int main(int argc, char** argv)
+{
+    TestLookups();
+    TestWrapAround();
+    TestRetentionAndReset();
+    TestConcurrentReads();
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+        Bench();
+
+    return CheckResult("StateHistoryTest");
+}
@@ -0,0 +1,144 @@
+// Tests StateTable's slots being acquired, released and reused, updates from an EventMapper showing up in snapshots,
+// and AxisFilterBank starting a reused slot's smoothing over rather than from the previous device's values.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP StateTableTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP StateTableTest.cpp -o StateTableTest
+//
+// Usage: StateTableTest
+
+#include <cmath>
+#include <vector>
+#include "Check.h"
+#include "WGIC/AxisFilterBank.h"
+#include "WGIC/StateTable.h"
+
+using namespace winrt::WGIC::Core;
+
+// A mapper with button 3 in bit 0 of byte 0 and axis 1 as a signed 16-bit value at byte 1, given one report
+static EventMapper MakeMapper(uint8_t buttons, int16_t axis)
+{
+    MappingList mappings = {
+        { ControlType::Button, 0, 0, 0, 0, false, 0, 3, ControlTransform::None },
+        { ControlType::Axis, 0, 1, 0, 2, true, 0, 1, ControlTransform::None },
+    };
+    EventMapper mapper(std::make_shared<const InputMap>(std::move(mappings)));
+
+    uint8_t report[] = { buttons, static_cast<uint8_t>(axis), static_cast<uint8_t>(static_cast<uint16_t>(axis) >> 8) };
+    EventQueue queue(16);
+    mapper.Process(1, 0, report, sizeof(report), ~0ull, queue);
+    return mapper;
+}
+
+static void TestAcquireRelease()
+{
+    StateTable table;
+    StateSnapshot snapshot;
+    table.Snapshot(snapshot);
+    CHECK(snapshot.ActiveSlots == 0);
+
+    std::vector<int32_t> slots;
+    for (size_t i = 0; i < MaxDeviceSlots; i++)
+        slots.push_back(table.AcquireSlot());
+    for (size_t i = 0; i < MaxDeviceSlots; i++)
+        CHECK(slots[i] == static_cast<int32_t>(i));
+    CHECK(table.AcquireSlot() == -1);
+
+    table.Snapshot(snapshot);
+    CHECK(snapshot.ActiveSlots == 0xFFFF);
+    CHECK(snapshot.Claims[0] == 1 && snapshot.Claims[MaxDeviceSlots - 1] == 1);
+
+    // A released slot is the next one handed out
+    table.ReleaseSlot(5);
+    table.Snapshot(snapshot);
+    CHECK(snapshot.ActiveSlots == (0xFFFFu & ~(1u << 5)));
+    CHECK(table.AcquireSlot() == 5);
+    table.Snapshot(snapshot);
+    CHECK(snapshot.ActiveSlots == 0xFFFF);
+    CHECK(snapshot.Claims[5] == 2 && snapshot.Claims[4] == 1);
+
+    // Out of range slots are ignored
+    uint64_t generation = snapshot.Generation;
+    table.ReleaseSlot(-1);
+    table.ReleaseSlot(static_cast<int32_t>(MaxDeviceSlots));
+    table.Snapshot(snapshot);
+    CHECK(snapshot.ActiveSlots == 0xFFFF && snapshot.Generation == generation);
+}
+
+static void TestUpdateAndReuse()
+{
+    StateTable table;
+    int32_t slot = table.AcquireSlot();
+    int32_t other = table.AcquireSlot();
+
+    StateSnapshot snapshot;
+    table.Snapshot(snapshot);
+    uint64_t generation = snapshot.Generation;
+
+    table.Update(slot, 1000, MakeMapper(1, -1234));
+    table.Update(other, 2000, MakeMapper(0, 77));
+    table.Snapshot(snapshot);
+    CHECK(snapshot.Generation == generation + 2);
+    CHECK(snapshot.Timestamps[slot] == 1000 && snapshot.Buttons[slot] == (1u << 3) && snapshot.Axes[slot][1] == -1234);
+    CHECK(snapshot.Timestamps[other] == 2000 && snapshot.Buttons[other] == 0 && snapshot.Axes[other][1] == 77);
+    CHECK(snapshot.Axes[slot][0] == 0 && snapshot.Hats[slot][0] == 0);
+
+    table.Update(-1, 3000, MakeMapper(1, 1));
+    table.Update(static_cast<int32_t>(MaxDeviceSlots), 3000, MakeMapper(1, 1));
+    table.Snapshot(snapshot);
+    CHECK(snapshot.Generation == generation + 2);
+
+    // Whichever device takes the slot next starts from nothing, not from the previous device's controls
+    table.ReleaseSlot(slot);
+    CHECK(table.AcquireSlot() == slot);
+    table.Snapshot(snapshot);
+    CHECK(snapshot.Timestamps[slot] == 0 && snapshot.Buttons[slot] == 0 && snapshot.Axes[slot][1] == 0);
+    CHECK(snapshot.Timestamps[other] == 2000 && snapshot.Axes[other][1] == 77);
+}
+
+static void TestFiltersResetOnReuse()
+{
+    StateTable table;
+    AxisFilterBank bank;
+    int32_t slot = table.AcquireSlot();
+    int32_t other = table.AcquireSlot();
+
+    AxisFilterSettings settings {};
+    settings.Scale = 1.0f / 32767.0f;
+    settings.OuterDeadzone = 1.0f;
+    settings.Smoothing = AxisSmoothing::Exponential;
+    settings.SmoothingFactor = 0.1f;
+    bank.Configure(slot, 1, settings);
+    bank.Configure(other, 1, settings);
+
+    StateSnapshot snapshot;
+    float filtered[MaxDeviceSlots][AxesPerDevice];
+    table.Update(slot, 1, MakeMapper(0, 32767));
+    table.Update(other, 1, MakeMapper(0, 32767));
+    table.Snapshot(snapshot);
+    bank.Process(snapshot, filtered, 0.01f);
+    CHECK(std::abs(filtered[slot][1] - 1.0f) < 1e-4f);
+
+    // Still smoothing towards the old value
+    table.Update(slot, 2, MakeMapper(0, 0));
+    table.Update(other, 2, MakeMapper(0, 0));
+    table.Snapshot(snapshot);
+    bank.Process(snapshot, filtered, 0.01f);
+    CHECK(std::abs(filtered[slot][1] - 0.9f) < 1e-4f);
+    CHECK(std::abs(filtered[other][1] - 0.9f) < 1e-4f);
+
+    // A new device in the slot takes its first value as-is; the slot next to it keeps smoothing
+    table.ReleaseSlot(slot);
+    CHECK(table.AcquireSlot() == slot);
+    table.Update(slot, 3, MakeMapper(0, 0));
+    table.Snapshot(snapshot);
+    bank.Process(snapshot, filtered, 0.01f);
+    CHECK(std::abs(filtered[slot][1]) < 1e-4f);
+    CHECK(std::abs(filtered[other][1] - 0.81f) < 1e-4f);
+}
+
+int main()
+{
+    TestAcquireRelease();
+    TestUpdateAndReuse();
+    TestFiltersResetOnReuse();
+    return CheckResult("StateTableTest");
+}
@@ -0,0 +1,119 @@
+// Tests TickResampler, which turns reports at arbitrary times into one sample per fixed tick.
+//   cl /std:c++17 /O2 /EHsc /I..\UWP_CPP TickResamplerTest.cpp
+//   g++ -std=c++17 -O2 -I../UWP_CPP TickResamplerTest.cpp -o TickResamplerTest
+//
+// Usage: TickResamplerTest
+
+#include <chrono>
+#include <vector>
+#include "Check.h"
+#include "WGIC/TickResampler.h"
+
+using namespace winrt::WGIC::Core;
+
+static ControlState State(uint64_t buttons, int32_t axis0 = 0)
+{
+    ControlState state {};
+    state.Buttons = buttons;
+    state.Axes[0] = axis0;
+    return state;
+}
+
+static std::vector<TickSample> Drain(TickResampler& resampler)
+{
+    std::vector<TickSample> ticks(resampler.Size());
+    ticks.resize(resampler.Drain(ticks.data(), ticks.size()));
+    return ticks;
+}
+
+static void TestTicks()
+{
+    // 1 kHz ticks from microsecond timestamps
+    TickResampler resampler(1000, false, 64);
+    resampler.AddSample(10000, State(0));
+    resampler.AddSample(10400, State(1)); // A tap between ticks
+    resampler.AddSample(10600, State(0));
+    resampler.AddSample(12500, State(0));
+
+    auto ticks = Drain(resampler);
+    CHECK(ticks.size() == 2);
+    CHECK(ticks[0].Timestamp == 11000 && ticks[0].State.Buttons == 1 && ticks[0].ReportCount == 3);
+    CHECK(ticks[1].Timestamp == 12000 && ticks[1].State.Buttons == 0 && ticks[1].ReportCount == 0);
+}
+
+static void TestInterpolation()
+{
+    TickResampler resampler(1000, true, 64);
+    resampler.AddSample(0, State(0, 0));
+    resampler.AddSample(4000, State(0, 400));
+
+    auto ticks = Drain(resampler);
+    CHECK(ticks.size() == 4);
+    CHECK(ticks[0].State.Axes[0] == 100 && ticks[1].State.Axes[0] == 200 && ticks[2].State.Axes[0] == 300);
+    CHECK(ticks[3].State.Axes[0] == 400);
+}
+
+// After a gap far longer than the queue holds, only the ticks that fit are emitted, and quickly
+static void TestLongGap()
+{
+    TickResampler resampler(1000, true, 100);
+    resampler.AddSample(0, State(1));
+    resampler.AddSample(500, State(0));
+
+    // A day later
+    uint64_t later = 86400ull * 1000000 + 250;
+    auto start = std::chrono::steady_clock::now();
+    resampler.AddSample(later, State(0, 1000));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(seconds < 0.01);
+
+    auto ticks = Drain(resampler);
+    CHECK(ticks.size() == 100);
+    CHECK(ticks.back().Timestamp == 86400ull * 1000000);
+    CHECK(ticks.front().Timestamp == 86400ull * 1000000 - 99 * 1000);
+
+    // The tap before the gap belongs to a dropped tick
+    bool released = true;
+    for (auto const& tick : ticks)
+        released &= tick.State.Buttons == 0;
+    CHECK(released);
+
+    // Ticks carry on from there
+    resampler.AddSample(later + 1000, State(0));
+    ticks = Drain(resampler);
+    CHECK(ticks.size() == 1 && ticks[0].Timestamp == 86400ull * 1000000 + 1000);
+}
+
+static void TestAdvanceTo()
+{
+    TickResampler resampler(100, false, 8);
+    resampler.AddSample(0, State(2));
+    resampler.AdvanceTo(30000);
+    auto ticks = Drain(resampler);
+    CHECK(ticks.size() == 3 && ticks[2].Timestamp == 30000 && ticks[2].State.Buttons == 2);
+
+    resampler.AdvanceTo(UINT64_MAX / 2);
+    CHECK(resampler.Size() == 8);
+}
+
+// Tick times that aren't a whole number of timestamps apart
+static void TestUnevenTicks()
+{
+    TickResampler resampler(3, false, 8, 1000);
+    resampler.AddSample(0, State(0));
+    resampler.AddSample(2000, State(0));
+
+    auto ticks = Drain(resampler);
+    CHECK(ticks.size() == 6);
+    CHECK(ticks[0].Timestamp == 333 && ticks[1].Timestamp == 666 && ticks[5].Timestamp == 2000);
+}
+
+int main()
+{
+    TestTicks();
+    TestInterpolation();
+    TestLongGap();
+    TestAdvanceTo();
+    TestUnevenTicks();
+    return CheckResult("TickResamplerTest");
+}
@@ -48,6 +48,18 @@ App::App()
     GipDevice::RegisterInterfaceGuid(GUID_GIP_INPUT_DEVICE);
     // HidDevice::RegisterHardwareIds();
     XusbDevice::RegisterType(XusbDeviceType::Gamepad, XusbDeviceSubtype::Unknown);
+
+    // Always keep the last several seconds of traffic, in case the app crashes or a controller misbehaves.
+    // The previous launch's recording is kept as FlightRecording.prev.wgfr, next to this one in LocalState.
+    // A failure to start is already logged, and isn't worth failing to launch over.
+    try
+    {
+        auto path = Windows::Storage::ApplicationData::Current().LocalFolder().Path() + L"\\FlightRecording.wgfr";
+        FlightRecorder::Start(path, 16384, 64);
+    }
+    catch (winrt::hresult_error const&)
+    {
+    }
 }
 
 /// <summary>
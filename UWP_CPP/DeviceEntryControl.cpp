@@ -1,35 +1,64 @@
 ﻿#include "pch.h"
 #include "DeviceEntryControl.h"
 #include "DeviceEntryControl.g.cpp"
+#include "EventFormat.h"
+#include "WGIC/DeviceTypes.h"
 
 namespace winrt::UWP_CPP::implementation
 {
+    // TDevice is the device's implementation type, which is called directly rather than through its interfaces
     template<typename TDevice>
     struct DeviceEntryT : DeviceEntry
     {
     protected:
-        TDevice m_device;
-        uint64_t m_timestamp;
+        WGIC::ICustomDevice m_device; // Keeps m_self alive
+        TDevice* m_self;
+        WGIC::DeviceDescriptor m_descriptor;
+        uint64_t m_timestamp = 0;
+
+        // Reused between events so that steady-state reading and formatting doesn't allocate
+        std::vector<uint8_t> m_readBuffer = std::vector<uint8_t>(64);
+        fmt::wmemory_buffer m_eventBuffer;
 
     public:
-        DeviceEntryT(TDevice device)
-            : m_device(device)
+        DeviceEntryT(WGIC::ICustomDevice const& device)
+            : m_device(device), m_self(winrt::get_self<TDevice>(device)), m_descriptor(m_self->GetDescriptor())
         {
         }
 
-        uint16_t VendorId() { return m_device.VendorId(); }
-        uint16_t ProductId() { return m_device.ProductId(); }
-        Custom::GameControllerVersionInfo HardwareVersion() { return m_device.HardwareVersion(); }
-        Custom::GameControllerVersionInfo FirmwareVersion() { return m_device.FirmwareVersion(); }
-    };
+        WGIC::DeviceDescriptor Descriptor() { return m_descriptor; }
 
-    struct HidDeviceEntry : DeviceEntryT<WGIC::HidDevice>
-    {
-        HidDeviceEntry(WGIC::HidDevice device)
-            : DeviceEntryT(device)
+    protected:
+        // Reads data into the read buffer using the given copy function, growing the buffer if it's too small.
+        // Returns the number of valid bytes in the buffer.
+        template<typename TCopy>
+        uint32_t ReadLatest(TCopy&& copy)
         {
+            uint32_t length = copy(winrt::array_view<uint8_t>(m_readBuffer));
+            if (length > m_readBuffer.size())
+            {
+                m_readBuffer.resize(length);
+                length = copy(winrt::array_view<uint8_t>(m_readBuffer));
+            }
+
+            return std::min<uint32_t>(length, static_cast<uint32_t>(m_readBuffer.size()));
         }
 
+        winrt::hstring FormattedEvent()
+        {
+            return winrt::hstring(std::wstring_view(m_eventBuffer.data(), m_eventBuffer.size()));
+        }
+    };
+
+    // The entry for each type in WGIC::SupportedDevices, which is what the constructor dispatches on
+    template<typename TDevice>
+    struct DeviceEntryOf;
+
+    template<>
+    struct DeviceEntryOf<WGIC::implementation::HidDevice> : DeviceEntryT<WGIC::implementation::HidDevice>
+    {
+        using DeviceEntryT::DeviceEntryT;
+
         winrt::hstring DeviceType()
         {
             return L"HID Device";
@@ -39,32 +68,24 @@ namespace winrt::UWP_CPP::implementation
         {
             uint64_t timestamp;
             uint8_t reportId;
-            winrt::com_array<uint8_t> reportBuffer;
-            m_device.GetLatestReport(timestamp, reportId, reportBuffer);
+            WGIC::ReportChange change;
+            uint32_t length = ReadLatest([&](winrt::array_view<uint8_t> buffer) {
+                return m_self->CopyLatestReport(timestamp, reportId, buffer, change);
+            });
 
-            if (timestamp != m_timestamp)
-            {
-                m_timestamp = timestamp;
-                std::wstring event = fmt::format(L"Timestamp: {}, ID: 0x{:02X}, length: {}\n{}\n",
-                    timestamp, reportId, reportBuffer.size(),
-                    Utilities::BytesToHex(reportBuffer.data(), reportBuffer.size())
-                );
-                return winrt::hstring(event);
-            }
-            else
-            {
+            if (timestamp == m_timestamp)
                 return winrt::hstring();
-            }
 
+            m_timestamp = timestamp;
+            EventFormat::FormatReport(m_eventBuffer, timestamp, reportId, m_readBuffer.data(), length);
+            return FormattedEvent();
         }
     };
 
-    struct XusbDeviceEntry : DeviceEntryT<WGIC::XusbDevice>
+    template<>
+    struct DeviceEntryOf<WGIC::implementation::XusbDevice> : DeviceEntryT<WGIC::implementation::XusbDevice>
     {
-        XusbDeviceEntry(WGIC::XusbDevice device)
-            : DeviceEntryT(device)
-        {
-        }
+        using DeviceEntryT::DeviceEntryT;
 
         winrt::hstring DeviceType()
         {
@@ -75,33 +96,24 @@ namespace winrt::UWP_CPP::implementation
         {
             uint64_t timestamp;
             uint8_t reportId;
-            winrt::com_array<uint8_t> reportBuffer;
-            m_device.GetLatestInput(timestamp, reportId, reportBuffer);
-
-            if (timestamp != m_timestamp)
-            {
-                m_timestamp = timestamp;
+            WGIC::ReportChange change;
+            uint32_t length = ReadLatest([&](winrt::array_view<uint8_t> buffer) {
+                return m_self->CopyLatestInput(timestamp, reportId, buffer, change);
+            });
 
-                std::wstring event = fmt::format(L"Timestamp: {}, ID: 0x{:02X}, length: {}\n{}\n",
-                    timestamp, reportId, reportBuffer.size(),
-                    Utilities::BytesToHex(reportBuffer.data(), reportBuffer.size())
-                );
-
-                return winrt::hstring(event);
-            }
-            else
-            {
+            if (timestamp == m_timestamp)
                 return winrt::hstring();
-            }
+
+            m_timestamp = timestamp;
+            EventFormat::FormatReport(m_eventBuffer, timestamp, reportId, m_readBuffer.data(), length);
+            return FormattedEvent();
         }
     };
 
-    struct GipDeviceEntry : DeviceEntryT<WGIC::GipDevice>
+    template<>
+    struct DeviceEntryOf<WGIC::implementation::GipDevice> : DeviceEntryT<WGIC::implementation::GipDevice>
     {
-        GipDeviceEntry(WGIC::GipDevice device)
-            : DeviceEntryT(device)
-        {
-        }
+        using DeviceEntryT::DeviceEntryT;
 
         winrt::hstring DeviceType()
         {
@@ -114,58 +126,34 @@ namespace winrt::UWP_CPP::implementation
             Custom::GipMessageClass messageClass;
             uint8_t messageId;
             uint8_t sequenceId;
-            winrt::com_array<uint8_t> messageBuffer;
-            m_device.GetLatestMessage(timestamp, messageClass, messageId, sequenceId, messageBuffer);
+            WGIC::ReportChange change;
+            uint32_t length = ReadLatest([&](winrt::array_view<uint8_t> buffer) {
+                return m_self->CopyLatestMessage(timestamp, messageClass, messageId, sequenceId, buffer, change);
+            });
 
-            if (timestamp != m_timestamp)
-            {
-                m_timestamp = timestamp;
-
-                std::wstring messageClassName;
-                switch (messageClass)
-                {
-                case Custom::GipMessageClass::Command: messageClassName = L"Command"; break;
-                case Custom::GipMessageClass::LowLatency: messageClassName = L"LowLatency"; break;
-                case Custom::GipMessageClass::StandardLatency: messageClassName = L"StandardLatency"; break;
-                default: messageClassName = std::to_wstring((uint32_t)messageClass); break;
-                }
-
-                std::wstring event = fmt::format(L"Timestamp: {}, class: {}, ID: 0x{:02X}, sequence: {}, length: {}\n{}\n",
-                    timestamp, messageClassName, messageId, sequenceId, messageBuffer.size(),
-                    Utilities::BytesToHex(messageBuffer.data(), messageBuffer.size())
-                );
-
-                return winrt::hstring(event);
-            }
-            else
-            {
+            if (timestamp == m_timestamp)
                 return winrt::hstring();
-            }
+
+            m_timestamp = timestamp;
+            EventFormat::FormatGipMessage(m_eventBuffer, timestamp, static_cast<uint32_t>(messageClass), messageId, sequenceId,
+                m_readBuffer.data(), length);
+            return FormattedEvent();
         }
     };
 
     DeviceEntryControl::DeviceEntryControl(Input::IGameController device)
     {
-        auto hid = device.try_as<WGIC::HidDevice>();
-        if (hid != nullptr)
-        {
-            m_entry = std::make_unique<HidDeviceEntry>(hid);
-            return;
-        }
-
-        auto xusb = device.try_as<WGIC::XusbDevice>();
-        if (xusb != nullptr)
+        // The kind tells us which implementation the device is, so after this one QueryInterface the entry calls
+        // it directly. A kind added to WGIC::SupportedDevices without a DeviceEntryOf fails to compile here.
+        auto customDevice = device.try_as<WGIC::ICustomDevice>();
+        bool handled = customDevice && WGIC::SupportedDevices::ForKind(customDevice.Kind(), [&](auto* type)
         {
-            m_entry = std::make_unique<XusbDeviceEntry>(xusb);
-            return;
-        }
+            using TDevice = std::remove_pointer_t<decltype(type)>;
+            m_entry = std::make_unique<DeviceEntryOf<TDevice>>(customDevice);
+        });
 
-        auto gip = device.try_as<WGIC::GipDevice>();
-        if (gip != nullptr)
-        {
-            m_entry = std::make_unique<GipDeviceEntry>(gip);
+        if (handled)
             return;
-        }
 
         auto logger = spdlog::get(s_loggerName)->clone("DeviceEntryControl::ctor");
         logger->debug("Invalid device received!");
@@ -178,11 +166,12 @@ namespace winrt::UWP_CPP::implementation
         DeviceEntryControlT::InitializeComponent();
 
         titleText().Text(m_entry->DeviceType());
-        auto hardware = m_entry->HardwareVersion();
-        auto firmware = m_entry->FirmwareVersion();
+        auto descriptor = m_entry->Descriptor();
+        auto& hardware = descriptor.HardwareVersion;
+        auto& firmware = descriptor.FirmwareVersion;
         infoText().Text(fmt::format(L"Vendor ID: 0x{:04X}\nProduct ID: 0x{:04X}\n"
             "Hardware Version: v{}.{}.{}.{}\nFirmware Version: v{}.{}.{}.{}",
-            m_entry->VendorId(), m_entry->ProductId(),
+            descriptor.VendorId, descriptor.ProductId,
             hardware.Major, hardware.Minor, hardware.Build, hardware.Revision,
             firmware.Major, firmware.Minor, firmware.Build, firmware.Revision
         ));
@@ -203,24 +192,9 @@ namespace winrt::UWP_CPP::implementation
         return m_entry->DeviceType();
     }
 
-    uint16_t DeviceEntryControl::VendorId()
-    {
-        return m_entry->VendorId();
-    }
-
-    uint16_t DeviceEntryControl::ProductId()
-    {
-        return m_entry->ProductId();
-    }
-
-    Custom::GameControllerVersionInfo DeviceEntryControl::HardwareVersion()
-    {
-        return m_entry->HardwareVersion();
-    }
-
-    Custom::GameControllerVersionInfo DeviceEntryControl::FirmwareVersion()
+    WGIC::DeviceDescriptor DeviceEntryControl::Descriptor()
     {
-        return m_entry->FirmwareVersion();
+        return m_entry->Descriptor();
     }
 
     winrt::hstring DeviceEntryControl::GetNextEvent()
@@ -9,10 +9,7 @@ namespace winrt::UWP_CPP::implementation
         virtual ~DeviceEntry() { };
 
         virtual winrt::hstring DeviceType() = 0;
-        virtual uint16_t VendorId() = 0;
-        virtual uint16_t ProductId() = 0;
-        virtual Custom::GameControllerVersionInfo HardwareVersion() = 0;
-        virtual Custom::GameControllerVersionInfo FirmwareVersion() = 0;
+        virtual WGIC::DeviceDescriptor Descriptor() = 0;
         virtual winrt::hstring GetNextEvent() = 0;
     };
 
@@ -30,10 +27,7 @@ namespace winrt::UWP_CPP::implementation
         void SelectButtonClicked(winrt::event_token const& token) noexcept;
 
         winrt::hstring DeviceType();
-        uint16_t VendorId();
-        uint16_t ProductId();
-        Custom::GameControllerVersionInfo HardwareVersion();
-        Custom::GameControllerVersionInfo FirmwareVersion();
+        WGIC::DeviceDescriptor Descriptor();
         winrt::hstring GetNextEvent();
 
         void selectButton_Clicked(Foundation::IInspectable const& sender, Xaml::RoutedEventArgs const& args);
@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+#include <string_view>
+#include "EventLog.h"
+
+// Collects event lines from a worker thread and hands them off to a consumer (usually the UI thread)
+// in batches, at most once per frame interval. Lines beyond the batch capacity drop the oldest ones.
+// This is platform-neutral: scheduling a flush is done through a caller-provided dispatch function.
+class EventBatcher
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+private:
+    std::mutex m_lock;
+    EventLog m_pending;
+    clock::duration m_interval;
+    clock::time_point m_lastFlush {};
+    bool m_flushScheduled = false;
+
+public:
+    EventBatcher(size_t capacity, clock::duration interval)
+        : m_pending(capacity), m_interval(interval)
+    {
+    }
+
+    void Add(std::wstring_view line)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pending.Push(line);
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_pending.Clear();
+    }
+
+    // Calls dispatch if there are pending lines, no flush is outstanding, and a frame interval has passed
+    // since the last flush. dispatch should schedule a call to Take without waiting for it. If dispatch throws,
+    // nothing was scheduled, so a later Pump may try again.
+    template<typename TDispatch>
+    bool Pump(clock::time_point now, TDispatch&& dispatch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_flushScheduled || m_pending.Empty() || now - m_lastFlush < m_interval)
+                return false;
+
+            m_flushScheduled = true;
+        }
+
+        try
+        {
+            dispatch();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_flushScheduled = false;
+            throw;
+        }
+
+        return true;
+    }
+
+    // Moves all pending lines into batch, replacing its contents, and allows the next flush to be scheduled.
+    // batch should have the same capacity as this batcher so that the two can swap storage without allocating.
+    void Take(EventLog& batch, clock::time_point now)
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        std::swap(batch, m_pending);
+        m_pending.Clear();
+        m_lastFlush = now;
+        m_flushScheduled = false;
+    }
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <fmt/core.h>
+#include <fmt/xchar.h>
+
+// Formats device events as shown in the event log. Each function replaces the contents of the buffer, so once it has
+// grown to fit the largest event, formatting doesn't allocate. Only depends on fmt and the standard library.
+namespace EventFormat
+{
+    constexpr wchar_t s_hexDigits[] = L"0123456789ABCDEF";
+
+    constexpr std::wstring_view s_gipMessageClassNames[] = {
+        L"Command",
+        L"LowLatency",
+        L"StandardLatency",
+    };
+
+    // Appends data as hyphen-separated hex, written in place
+    inline void AppendHex(fmt::wmemory_buffer& buffer, const uint8_t data[], size_t length)
+    {
+        if (!data || length < 1)
+            return;
+
+        const size_t start = buffer.size();
+        buffer.resize(start + length * 3 - 1); // No hyphen after the last byte
+
+        wchar_t* output = buffer.data() + start;
+        for (size_t dataIndex = 0; dataIndex < length; dataIndex++)
+        {
+            uint8_t value = data[dataIndex];
+            *output++ = s_hexDigits[value >> 4];
+            *output++ = s_hexDigits[value & 0x0F];
+            if (dataIndex < length - 1)
+                *output++ = L'-';
+        }
+    }
+
+    // An event for a HID report or XUSB input
+    inline void FormatReport(fmt::wmemory_buffer& buffer, uint64_t timestamp, uint8_t reportId,
+        const uint8_t data[], uint32_t length)
+    {
+        buffer.clear();
+        fmt::format_to(std::back_inserter(buffer), L"Timestamp: {}, ID: 0x{:02X}, length: {}\n",
+            timestamp, reportId, length
+        );
+        AppendHex(buffer, data, length);
+        buffer.push_back(L'\n');
+    }
+
+    // An event for a GIP message; messageClass is the value of a Windows.Gaming.Input.Custom.GipMessageClass
+    inline void FormatGipMessage(fmt::wmemory_buffer& buffer, uint64_t timestamp, uint32_t messageClass,
+        uint8_t messageId, uint8_t sequenceId, const uint8_t data[], uint32_t length)
+    {
+        buffer.clear();
+        auto back = std::back_inserter(buffer);
+        if (messageClass < std::size(s_gipMessageClassNames))
+            fmt::format_to(back, L"Timestamp: {}, class: {}, ", timestamp, s_gipMessageClassNames[messageClass]);
+        else
+            fmt::format_to(back, L"Timestamp: {}, class: {}, ", timestamp, messageClass);
+
+        fmt::format_to(back, L"ID: 0x{:02X}, sequence: {}, length: {}\n", messageId, sequenceId, length);
+        AppendHex(buffer, data, length);
+        buffer.push_back(L'\n');
+    }
+}
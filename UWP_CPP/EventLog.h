@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Fixed-capacity log of formatted event lines. Once full, each new line overwrites the oldest one,
+// so memory use stays bounded no matter how fast a device reports.
+// This is intentionally platform-neutral and does no locking of its own; callers must synchronize access.
+class EventLog
+{
+private:
+    std::vector<std::wstring> m_lines;
+    size_t m_head = 0; // Index of the oldest line
+    size_t m_count = 0;
+    uint64_t m_generation = 0;
+    uint64_t m_totalPushed = 0;
+
+public:
+    explicit EventLog(size_t capacity)
+        : m_lines(capacity > 0 ? capacity : 1)
+    {
+    }
+
+    size_t Capacity() const noexcept { return m_lines.size(); }
+    size_t Size() const noexcept { return m_count; }
+    bool Empty() const noexcept { return m_count == 0; }
+
+    // Incremented on every modification, so readers can tell whether they need to re-render
+    uint64_t Generation() const noexcept { return m_generation; }
+
+    // Total number of lines pushed since the last clear, including ones that have since been overwritten
+    uint64_t TotalPushed() const noexcept { return m_totalPushed; }
+
+    void Push(std::wstring_view line)
+    {
+        size_t index;
+        if (m_count < m_lines.size())
+        {
+            index = (m_head + m_count) % m_lines.size();
+            m_count++;
+        }
+        else
+        {
+            index = m_head;
+            m_head = (m_head + 1) % m_lines.size();
+        }
+
+        // Assigning into the existing string reuses its storage once the ring has filled up
+        m_lines[index].assign(line.data(), line.size());
+        m_totalPushed++;
+        m_generation++;
+    }
+
+    void Clear() noexcept
+    {
+        // Strings are kept around so their storage can be reused
+        m_head = 0;
+        m_count = 0;
+        m_totalPushed = 0;
+        m_generation++;
+    }
+
+    // Gets a retained line, where 0 is the oldest
+    std::wstring_view Line(size_t index) const noexcept
+    {
+        if (index >= m_count)
+            return {};
+
+        return m_lines[(m_head + index) % m_lines.size()];
+    }
+
+    // Renders the newest lineCount lines into the given string, replacing its contents
+    void RenderTail(std::wstring& output, size_t lineCount) const
+    {
+        output.clear();
+
+        if (lineCount > m_count)
+            lineCount = m_count;
+
+        size_t first = m_count - lineCount;
+        size_t length = 0;
+        for (size_t i = first; i < m_count; i++)
+        {
+            length += Line(i).size();
+        }
+
+        output.reserve(length);
+        for (size_t i = first; i < m_count; i++)
+        {
+            output.append(Line(i));
+        }
+    }
+};
@@ -45,15 +45,18 @@ namespace winrt::UWP_CPP::implementation
     {
         std::lock_guard<std::mutex> lock(m_entryLock);
         m_currentEntry = entry;
+        m_eventBatcher.Clear();
+        m_eventLog.Clear();
         deviceEvents().Text(L"");
 
         if (entry)
         {
-            auto hardware = entry.HardwareVersion();
-            auto firmware = entry.FirmwareVersion();
+            auto descriptor = entry.Descriptor();
+            auto& hardware = descriptor.HardwareVersion;
+            auto& firmware = descriptor.FirmwareVersion;
             currentDeviceInfo().Text(fmt::format(L"Device type: {}\nVendor ID: 0x{:04X}\nProduct ID: 0x{:04X}\n"
                 "Hardware Version: v{}.{}.{}.{}\nFirmware Version: v{}.{}.{}.{}",
-                entry.DeviceType(), entry.VendorId(), entry.ProductId(),
+                entry.DeviceType(), descriptor.VendorId, descriptor.ProductId,
                 hardware.Major, hardware.Minor, hardware.Build, hardware.Revision,
                 firmware.Major, firmware.Minor, firmware.Build, firmware.Revision
             ));
@@ -101,29 +104,49 @@ namespace winrt::UWP_CPP::implementation
 
     void MainPage::EntryEventThread()
     {
-        while (WaitForSingleObjectEx(m_threadStop.get(), 0, false) == WAIT_TIMEOUT)
+        // Polls without waiting while events keep coming, and otherwise sleeps briefly so an idle device doesn't
+        // keep a core busy
+        DWORD wait = 0;
+        while (WaitForSingleObjectEx(m_threadStop.get(), wait, false) == WAIT_TIMEOUT)
         {
             winrt::hstring event;
             {
+                // Added under the same lock as it was read, so that SelectEntry's Clear can't land in between and
+                // let the old entry's event into the new entry's log
                 std::lock_guard<std::mutex> lock(m_entryLock);
-                if (m_currentEntry == nullptr)
-                    continue;
-
-                event = m_currentEntry.GetNextEvent();
+                if (m_currentEntry != nullptr)
+                    event = m_currentEntry.GetNextEvent();
+                if (!event.empty())
+                    m_eventBatcher.Add(event);
             }
-            if (event.empty())
-                continue;
-
-            // Update UI
-            Dispatcher().RunAsync(UI::Core::CoreDispatcherPriority::Normal, [&]{
-                // Write event to textbox
-                auto text = deviceEvents().Text();
-                deviceEvents().Text(text + event);
-
-                // Scroll to the bottom of the textbox
-                deviceEventsScroll().ChangeView(nullptr, deviceEventsScroll().ScrollableHeight() + 1.0, nullptr, true);
-            }).get();
+            wait = event.empty() ? 1 : 0;
+
+            // Hand pending events off to the UI at most once per frame, without waiting on it
+            m_eventBatcher.Pump(EventBatcher::clock::now(), [&]{
+                Dispatcher().RunAsync(UI::Core::CoreDispatcherPriority::Normal, [this, strongThis = get_strong()]{
+                    FlushEvents();
+                });
+            });
+        }
+    }
+
+    void MainPage::FlushEvents()
+    {
+        m_eventBatcher.Take(m_eventBatch, EventBatcher::clock::now());
+        if (m_eventBatch.Empty())
+            return;
+
+        for (size_t i = 0; i < m_eventBatch.Size(); i++)
+        {
+            m_eventLog.Push(m_eventBatch.Line(i));
         }
+
+        // Write the visible portion of the event log to the textbox
+        m_eventLog.RenderTail(m_eventText, s_visibleEventCount);
+        deviceEvents().Text(m_eventText);
+
+        // Scroll to the bottom of the textbox
+        deviceEventsScroll().ChangeView(nullptr, deviceEventsScroll().ScrollableHeight() + 1.0, nullptr, true);
     }
 
     void MainPage::OnHidDeviceListChanged(Foundation::IInspectable const&, WGIC::HidDevice const&)
@@ -1,10 +1,17 @@
 ﻿#pragma once
 #include "MainPage.g.h"
+#include "EventLog.h"
+#include "EventBatcher.h"
 
 namespace winrt::UWP_CPP::implementation
 {
     struct MainPage : MainPageT<MainPage>
     {
+    private:
+        static constexpr size_t s_eventLogCapacity = 256;
+        static constexpr size_t s_visibleEventCount = 64;
+        static constexpr std::chrono::microseconds s_eventFlushInterval { 16667 }; // One frame at 60 Hz
+
     public:
         MainPage() = default;
 
@@ -26,6 +33,13 @@ namespace winrt::UWP_CPP::implementation
 
         TestApp::DeviceEntryControl m_currentEntry { nullptr };
         std::thread m_eventThread;
+
+        EventBatcher m_eventBatcher { s_eventLogCapacity, s_eventFlushInterval };
+
+        // Only accessed from the UI thread
+        EventLog m_eventLog { s_eventLogCapacity };
+        EventLog m_eventBatch { s_eventLogCapacity };
+        std::wstring m_eventText;
         winrt::handle m_threadStop { CreateEvent(nullptr, true, false, nullptr) };
 
         void AddDevice(Input::IGameController device);
@@ -33,6 +47,7 @@ namespace winrt::UWP_CPP::implementation
         void RefreshDevices();
 
         void EntryEventThread();
+        void FlushEvents();
 
         void OnHidDeviceListChanged(Foundation::IInspectable const& sender, WGIC::HidDevice const& device);
         void OnXusbDeviceListChanged(Foundation::IInspectable const& sender, WGIC::XusbDevice const& device);
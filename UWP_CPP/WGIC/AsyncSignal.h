@@ -0,0 +1,181 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // Runs a continuation somewhere, such as on a particular thread. An empty executor runs it inline.
+    using Executor = std::function<void(std::function<void()>)>;
+
+    // Counts occurrences of something (a report arriving, a device being added) and resumes whoever is waiting
+    // for the next one. Waiters are coroutines via Next(), or plain callbacks via Wait().
+    // The awaiter works with any coroutine handle type, so this doesn't depend on a particular coroutine header.
+    class AsyncSignal
+    {
+    private:
+        struct Waiter
+        {
+            Core::Executor Run;
+            std::function<void()> Continuation;
+        };
+
+        std::mutex m_lock;
+        uint64_t m_count = 0;
+        std::vector<Waiter> m_waiters;
+
+    public:
+        class Awaiter
+        {
+        private:
+            AsyncSignal& m_signal;
+            uint64_t m_after;
+            Executor m_executor;
+
+        public:
+            Awaiter(AsyncSignal& signal, uint64_t after, Executor executor)
+                : m_signal(signal), m_after(after), m_executor(std::move(executor))
+            {
+            }
+
+            bool await_ready()
+            {
+                return m_signal.Count() > m_after;
+            }
+
+            // Returning false resumes straight away, for when the signal fired after await_ready
+            template<typename THandle>
+            bool await_suspend(THandle handle)
+            {
+                return m_signal.Wait(m_after, m_executor, [handle]() mutable { handle.resume(); });
+            }
+
+            // Returns the count at the time of resuming
+            uint64_t await_resume()
+            {
+                return m_signal.Count();
+            }
+        };
+
+        uint64_t Count()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_count;
+        }
+
+        // Waits for the next occurrence after the current one
+        Awaiter Next(Executor executor = {})
+        {
+            return Awaiter(*this, Count(), std::move(executor));
+        }
+
+        // Registers a continuation to run once the count goes past after.
+        // Returns false without registering if it already has.
+        bool Wait(uint64_t after, Executor executor, std::function<void()> continuation)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_count > after)
+                return false;
+
+            m_waiters.push_back({ std::move(executor), std::move(continuation) });
+            return true;
+        }
+
+        // Counts an occurrence and resumes every waiter. Continuations may run inline, so this must not be called
+        // while holding a lock that a waiter might take.
+        void Notify()
+        {
+            std::vector<Waiter> waiters;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_count++;
+                if (m_waiters.empty())
+                    return;
+
+                waiters.swap(m_waiters);
+            }
+
+            for (auto& waiter : waiters)
+            {
+                if (waiter.Run)
+                    waiter.Run(std::move(waiter.Continuation));
+                else
+                    waiter.Continuation();
+            }
+        }
+    };
+
+    // A queue of work run by whichever thread calls Run, so one thread can service any number of waits
+    class RunLoop
+    {
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_ready;
+        std::deque<std::function<void()>> m_queue;
+        bool m_stopped = false;
+
+    public:
+        Executor GetExecutor()
+        {
+            return [this](std::function<void()> work) { Post(std::move(work)); };
+        }
+
+        void Post(std::function<void()> work)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_queue.push_back(std::move(work));
+            }
+            m_ready.notify_one();
+        }
+
+        // Runs all queued work, including anything queued along the way, returning how much was run
+        size_t RunPending()
+        {
+            size_t count = 0;
+            while (RunOne(false))
+                count++;
+            return count;
+        }
+
+        // Runs queued work until Stop is called
+        void Run()
+        {
+            while (RunOne(true))
+            {
+            }
+        }
+
+        void Stop()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_stopped = true;
+            }
+            m_ready.notify_all();
+        }
+
+    private:
+        bool RunOne(bool wait)
+        {
+            std::function<void()> work;
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                if (wait)
+                    m_ready.wait(lock, [this] { return m_stopped || !m_queue.empty(); });
+                if (m_queue.empty() || (wait && m_stopped))
+                    return false;
+
+                work = std::move(m_queue.front());
+                m_queue.pop_front();
+            }
+
+            work();
+            return true;
+        }
+    };
+}
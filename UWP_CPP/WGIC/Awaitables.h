@@ -0,0 +1,113 @@
+#pragma once
+#include "pch.h"
+#include "WGIC/AsyncSignal.h"
+#include "WGIC/DeviceTypes.h"
+
+// Awaitables for C++/WinRT consumers, so a single thread (or the UI thread) can service any number of devices
+// instead of dedicating a polling thread to each one:
+//
+//     while (device.IsConnected())
+//     {
+//         co_await WGIC::NextReport(device, WGIC::DispatcherExecutor(Dispatcher()));
+//         ... read the device ...
+//     }
+//
+// Without an executor the coroutine is resumed directly on the thread that signalled it, which for reports is
+// the worker processing the device's reports, so it should do as little as possible before awaiting again.
+namespace winrt::WGIC
+{
+    // Keeps the device alive for as long as something is waiting on it, for reports or for it to be ready
+    class ReportAwaiter
+    {
+    private:
+        WGIC::ICustomDevice m_device;
+        Core::AsyncSignal::Awaiter m_awaiter;
+
+    public:
+        ReportAwaiter(WGIC::ICustomDevice const& device, Core::AsyncSignal::Awaiter awaiter)
+            : m_device(device), m_awaiter(std::move(awaiter))
+        {
+        }
+
+        bool await_ready()
+        {
+            return m_awaiter.await_ready();
+        }
+
+        template<typename THandle>
+        bool await_suspend(THandle handle)
+        {
+            return m_awaiter.await_suspend(handle);
+        }
+
+        // Returns the number of times the device has been signalled
+        uint64_t await_resume()
+        {
+            return m_awaiter.await_resume();
+        }
+    };
+
+    // Resumes after the device's next report, or after it's removed
+    inline ReportAwaiter NextReport(WGIC::ICustomDevice const& device, Core::Executor executor = {})
+    {
+        Core::AsyncSignal* signal = nullptr;
+        if (device)
+        {
+            SupportedDevices::ForKind(device.Kind(), [&](auto* type)
+            {
+                using TDevice = std::remove_pointer_t<decltype(type)>;
+                signal = &winrt::get_self<TDevice>(device)->ReportSignal();
+            });
+        }
+
+        if (!signal)
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("WGIC::NextReport");
+            logger->error("Invalid device received!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        return ReportAwaiter(device, signal->Next(std::move(executor)));
+    }
+
+    // Resumes once the device is ready, straight away if it already is, or once it's removed
+    inline ReportAwaiter WhenReady(WGIC::ICustomDevice const& device, Core::Executor executor = {})
+    {
+        Core::AsyncSignal* signal = nullptr;
+        if (device)
+        {
+            SupportedDevices::ForKind(device.Kind(), [&](auto* type)
+            {
+                using TDevice = std::remove_pointer_t<decltype(type)>;
+                signal = &winrt::get_self<TDevice>(device)->ReadySignal();
+            });
+        }
+
+        if (!signal)
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("WGIC::WhenReady");
+            logger->error("Invalid device received!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        return ReportAwaiter(device, Core::AsyncSignal::Awaiter(*signal, 0, std::move(executor)));
+    }
+
+    // Resumes after the next device of any kind is added or removed
+    inline Core::AsyncSignal::Awaiter NextDeviceChange(Core::Executor executor = {})
+    {
+        return DeviceFactory::DevicesChanged().Next(std::move(executor));
+    }
+
+    // Runs continuations on a dispatcher's thread, such as the UI thread
+    inline Core::Executor DispatcherExecutor(UI::Core::CoreDispatcher const& dispatcher)
+    {
+        return [dispatcher](std::function<void()> continuation)
+        {
+            dispatcher.RunAsync(UI::Core::CoreDispatcherPriority::Normal, [continuation = std::move(continuation)]
+            {
+                continuation();
+            });
+        };
+    }
+}
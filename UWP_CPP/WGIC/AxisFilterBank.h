@@ -0,0 +1,282 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include "WGIC/StateTable.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WGIC_AXIS_FILTER_SSE2
+#endif
+
+namespace winrt::WGIC::Core
+{
+    enum class AxisSmoothing : uint8_t
+    {
+        None,
+        Exponential,
+        OneEuro,
+    };
+
+    struct AxisFilterSettings
+    {
+        // Raw values are normalized to [-1, 1] with (raw - Center) * Scale
+        int32_t Center;
+        float Scale;
+
+        // Values with a magnitude below the inner deadzone become 0, above the outer deadzone become 1,
+        // and are rescaled in between. A radial deadzone uses the magnitude of the axis pair (0/1, 2/3, ...)
+        // that this axis is part of, instead of just this axis.
+        float InnerDeadzone;
+        float OuterDeadzone;
+        bool RadialDeadzone;
+
+        // Blend between a linear (0) and cubic (1) response curve
+        float CurveCubic;
+
+        AxisSmoothing Smoothing;
+        float SmoothingFactor;  // Exponential: weight given to each new value
+        float MinCutoff;        // One-Euro: cutoff frequency in Hz when the axis is still
+        float Beta;             // One-Euro: how quickly the cutoff rises with speed
+        float DerivativeCutoff; // One-Euro: cutoff frequency in Hz for the speed estimate
+    };
+
+    // Deadzone, response curve and smoothing filters for every axis of every device slot.
+    // Settings and filter state are stored as contiguous per-lane arrays (one lane per slot axis),
+    // so all axes are filtered together in a single pass, 4 lanes at a time where SSE2 is available.
+    class AxisFilterBank
+    {
+    public:
+        static constexpr size_t LaneCount = MaxDeviceSlots * AxesPerDevice;
+        static_assert(LaneCount % 4 == 0, "Lane count must be a multiple of the vector width");
+        static_assert(AxesPerDevice % 2 == 0, "Radial deadzones require axes to come in pairs");
+
+    private:
+        alignas(16) float m_center[LaneCount];
+        alignas(16) float m_scale[LaneCount];
+        alignas(16) float m_inner[LaneCount];
+        alignas(16) float m_range[LaneCount]; // Reciprocal of (outer - inner)
+        alignas(16) float m_radial[LaneCount]; // 1 for radial, 0 for axial
+        alignas(16) float m_cubic[LaneCount];
+        alignas(16) float m_fixedAlpha[LaneCount]; // 1 for no smoothing
+        alignas(16) float m_oneEuro[LaneCount]; // 1 for One-Euro, 0 otherwise
+        alignas(16) float m_minCutoff[LaneCount];
+        alignas(16) float m_beta[LaneCount];
+        alignas(16) float m_derivativeCutoff[LaneCount];
+
+        alignas(16) float m_previous[LaneCount];
+        alignas(16) float m_previousDerivative[LaneCount];
+        alignas(16) float m_primed[LaneCount]; // 1 once a lane has had its first value
+
+        uint32_t m_claims[MaxDeviceSlots] {}; // StateSnapshot::Claims as of the last snapshot processed
+
+    public:
+        AxisFilterBank()
+        {
+            AxisFilterSettings defaults {};
+            defaults.Scale = 1.0f / 32767.0f;
+            defaults.OuterDeadzone = 1.0f;
+            for (size_t lane = 0; lane < LaneCount; lane++)
+            {
+                Configure(lane, defaults);
+            }
+        }
+
+        void Configure(size_t slot, size_t axis, AxisFilterSettings const& settings)
+        {
+            if (slot < MaxDeviceSlots && axis < AxesPerDevice)
+                Configure(slot * AxesPerDevice + axis, settings);
+        }
+
+        // Resets the smoothing state of a slot, such as when a new device takes it over
+        void Reset(size_t slot)
+        {
+            if (slot >= MaxDeviceSlots)
+                return;
+
+            for (size_t lane = slot * AxesPerDevice; lane < (slot + 1) * AxesPerDevice; lane++)
+            {
+                m_previous[lane] = 0;
+                m_previousDerivative[lane] = 0;
+                m_primed[lane] = 0;
+            }
+        }
+
+        // Filters raw axis values for every lane, writing normalized results to output.
+        // deltaTime is the time in seconds since the previous call.
+        void Process(const int32_t (&raw)[MaxDeviceSlots][AxesPerDevice], float (&output)[MaxDeviceSlots][AxesPerDevice],
+            float deltaTime)
+        {
+#ifdef WGIC_AXIS_FILTER_SSE2
+            ProcessSse2(raw, output, deltaTime);
+#else
+            ProcessScalar(raw, output, deltaTime);
+#endif
+        }
+
+        // Filters the axes of a snapshot, first resetting the smoothing state of any slot that was acquired since the
+        // last snapshot, so that a device taking over a slot doesn't start from the previous device's values
+        void Process(StateSnapshot const& snapshot, float (&output)[MaxDeviceSlots][AxesPerDevice], float deltaTime)
+        {
+            for (size_t slot = 0; slot < MaxDeviceSlots; slot++)
+            {
+                if (snapshot.Claims[slot] != m_claims[slot])
+                {
+                    Reset(slot);
+                    m_claims[slot] = snapshot.Claims[slot];
+                }
+            }
+
+            Process(snapshot.Axes, output, deltaTime);
+        }
+
+#ifdef WGIC_AXIS_FILTER_SSE2
+        // Process 4 lanes at a time. Gives the same results as ProcessScalar, up to float rounding.
+        void ProcessSse2(const int32_t (&raw)[MaxDeviceSlots][AxesPerDevice], float (&output)[MaxDeviceSlots][AxesPerDevice],
+            float deltaTime)
+        {
+            const int32_t* input = &raw[0][0];
+            float* result = &output[0][0];
+            if (!(deltaTime > 0))
+                deltaTime = 1e-3f;
+
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 minusOne = _mm_set1_ps(-1.0f);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 epsilon = _mm_set1_ps(1e-6f);
+            const __m128 inverseDt = _mm_set1_ps(1.0f / deltaTime);
+            const __m128 twoPiDt = _mm_set1_ps(6.2831853f * deltaTime);
+
+            for (size_t lane = 0; lane < LaneCount; lane += 4)
+            {
+                // Normalize
+                __m128 raw4 = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + lane)));
+                __m128 x = _mm_mul_ps(_mm_sub_ps(raw4, _mm_load_ps(m_center + lane)), _mm_load_ps(m_scale + lane));
+                x = _mm_min_ps(_mm_max_ps(x, minusOne), one);
+
+                // Deadzone: the partner axis of each pair is found by swapping adjacent lanes
+                __m128 partner = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+                __m128 radialMagnitude = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(partner, partner)));
+                __m128 axialMagnitude = _mm_and_ps(x, absMask);
+                __m128 radial = _mm_load_ps(m_radial + lane);
+                __m128 magnitude = _mm_add_ps(axialMagnitude, _mm_mul_ps(radial, _mm_sub_ps(radialMagnitude, axialMagnitude)));
+
+                __m128 scaled = _mm_mul_ps(_mm_sub_ps(magnitude, _mm_load_ps(m_inner + lane)), _mm_load_ps(m_range + lane));
+                scaled = _mm_min_ps(_mm_max_ps(scaled, zero), one);
+                x = _mm_mul_ps(x, _mm_div_ps(scaled, _mm_max_ps(magnitude, epsilon)));
+
+                // Response curve
+                __m128 cubic = _mm_load_ps(m_cubic + lane);
+                __m128 x3 = _mm_mul_ps(_mm_mul_ps(x, x), x);
+                x = _mm_add_ps(x, _mm_mul_ps(cubic, _mm_sub_ps(x3, x)));
+
+                // Smoothing
+                __m128 previous = _mm_load_ps(m_previous + lane);
+                __m128 previousDerivative = _mm_load_ps(m_previousDerivative + lane);
+                __m128 derivative = _mm_mul_ps(_mm_sub_ps(x, previous), inverseDt);
+                __m128 derivativeAlpha = CutoffAlpha(_mm_load_ps(m_derivativeCutoff + lane), twoPiDt, one);
+                derivative = _mm_add_ps(previousDerivative, _mm_mul_ps(derivativeAlpha, _mm_sub_ps(derivative, previousDerivative)));
+
+                __m128 cutoff = _mm_add_ps(_mm_load_ps(m_minCutoff + lane),
+                    _mm_mul_ps(_mm_load_ps(m_beta + lane), _mm_and_ps(derivative, absMask)));
+                __m128 fixedAlpha = _mm_load_ps(m_fixedAlpha + lane);
+                __m128 alpha = _mm_add_ps(fixedAlpha,
+                    _mm_mul_ps(_mm_load_ps(m_oneEuro + lane), _mm_sub_ps(CutoffAlpha(cutoff, twoPiDt, one), fixedAlpha)));
+
+                // Lanes without a previous value take the new value as-is
+                __m128 primed = _mm_load_ps(m_primed + lane);
+                alpha = _mm_add_ps(one, _mm_mul_ps(primed, _mm_sub_ps(alpha, one)));
+                derivative = _mm_mul_ps(derivative, primed);
+
+                __m128 filtered = _mm_add_ps(previous, _mm_mul_ps(alpha, _mm_sub_ps(x, previous)));
+                _mm_store_ps(m_previous + lane, filtered);
+                _mm_store_ps(m_previousDerivative + lane, derivative);
+                _mm_store_ps(m_primed + lane, one);
+                _mm_storeu_ps(result + lane, filtered);
+            }
+        }
+#endif
+
+        // Process one lane at a time. Used where SSE2 isn't available.
+        void ProcessScalar(const int32_t (&raw)[MaxDeviceSlots][AxesPerDevice], float (&output)[MaxDeviceSlots][AxesPerDevice],
+            float deltaTime)
+        {
+            const int32_t* input = &raw[0][0];
+            float* result = &output[0][0];
+            if (!(deltaTime > 0))
+                deltaTime = 1e-3f;
+
+            const float twoPiDt = 6.2831853f * deltaTime;
+            float normalized[LaneCount];
+            for (size_t lane = 0; lane < LaneCount; lane++)
+            {
+                float x = (static_cast<float>(input[lane]) - m_center[lane]) * m_scale[lane];
+                normalized[lane] = std::fmin(std::fmax(x, -1.0f), 1.0f);
+            }
+
+            for (size_t lane = 0; lane < LaneCount; lane++)
+            {
+                // Deadzone
+                float x = normalized[lane];
+                float partner = normalized[lane ^ 1];
+                float magnitude = m_radial[lane] != 0 ? std::sqrt(x * x + partner * partner) : std::fabs(x);
+                float scaled = std::fmin(std::fmax((magnitude - m_inner[lane]) * m_range[lane], 0.0f), 1.0f);
+                x *= scaled / std::fmax(magnitude, 1e-6f);
+
+                // Response curve
+                x += m_cubic[lane] * (x * x * x - x);
+
+                // Smoothing
+                float previous = m_previous[lane];
+                float derivative = 0;
+                float alpha = 1;
+                if (m_primed[lane] != 0)
+                {
+                    float previousDerivative = m_previousDerivative[lane];
+                    derivative = (x - previous) / deltaTime;
+                    derivative = previousDerivative + CutoffAlpha(m_derivativeCutoff[lane], twoPiDt) * (derivative - previousDerivative);
+                    float cutoff = m_minCutoff[lane] + m_beta[lane] * std::fabs(derivative);
+                    alpha = m_oneEuro[lane] != 0 ? CutoffAlpha(cutoff, twoPiDt) : m_fixedAlpha[lane];
+                }
+
+                float filtered = previous + alpha * (x - previous);
+                m_previous[lane] = filtered;
+                m_previousDerivative[lane] = derivative;
+                m_primed[lane] = 1;
+                result[lane] = filtered;
+            }
+        }
+
+    private:
+        void Configure(size_t lane, AxisFilterSettings const& settings)
+        {
+            float outer = settings.OuterDeadzone > settings.InnerDeadzone ? settings.OuterDeadzone : settings.InnerDeadzone + 1e-6f;
+            m_center[lane] = static_cast<float>(settings.Center);
+            m_scale[lane] = settings.Scale;
+            m_inner[lane] = settings.InnerDeadzone;
+            m_range[lane] = 1.0f / (outer - settings.InnerDeadzone);
+            m_radial[lane] = settings.RadialDeadzone ? 1.0f : 0.0f;
+            m_cubic[lane] = settings.CurveCubic;
+            m_fixedAlpha[lane] = settings.Smoothing == AxisSmoothing::Exponential ? settings.SmoothingFactor : 1.0f;
+            m_oneEuro[lane] = settings.Smoothing == AxisSmoothing::OneEuro ? 1.0f : 0.0f;
+            m_minCutoff[lane] = settings.MinCutoff;
+            m_beta[lane] = settings.Beta;
+            m_derivativeCutoff[lane] = settings.DerivativeCutoff;
+        }
+
+#ifdef WGIC_AXIS_FILTER_SSE2
+        // Smoothing factor for a low-pass filter with the given cutoff frequency
+        static __m128 CutoffAlpha(__m128 cutoff, __m128 twoPiDt, __m128 one)
+        {
+            __m128 r = _mm_mul_ps(twoPiDt, cutoff);
+            return _mm_div_ps(r, _mm_add_ps(r, one));
+        }
+#endif
+
+        static float CutoffAlpha(float cutoff, float twoPiDt)
+        {
+            float r = twoPiDt * cutoff;
+            return r / (r + 1.0f);
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <string>
+#include "WGIC/BroadcastRing.h"
+#include "WGIC/SharedMemory.h"
+
+namespace winrt::WGIC::Core
+{
+    // Reads the reports published by a ReportExporter in another process.
+    // Only depends on the standard library and the OS, so it can be used by processes that don't use WinRT.
+    class BroadcastReader
+    {
+    private:
+        SharedMemory m_memory;
+        BroadcastRing m_ring;
+        BroadcastCursor m_cursor;
+
+    public:
+        // Opens the ring with the given name, starting either at the oldest report still in it or at the next new one
+        bool Open(std::string const& name, bool fromNow = true)
+        {
+            if (!m_memory.Open(name) || !m_ring.Attach(m_memory.Data(), m_memory.Size()))
+            {
+                Close();
+                return false;
+            }
+
+            m_cursor.Reset(m_ring, fromNow);
+            return true;
+        }
+
+        void Close() noexcept
+        {
+            m_ring = BroadcastRing();
+            m_memory.Close();
+        }
+
+        bool IsOpen() const noexcept { return m_ring.IsValid(); }
+
+        // Size that data buffers passed to Read need to be
+        uint32_t DataSize() const noexcept { return m_ring.IsValid() ? m_ring.DataSize() : 0; }
+
+        uint64_t Lost() const noexcept { return m_cursor.Lost(); }
+        uint64_t Lag() const noexcept { return m_ring.IsValid() ? m_cursor.Lag(m_ring) : 0; }
+
+        // Reads the next report, returning false once there are no new reports
+        bool Read(ReportRecord& record, uint8_t* data) noexcept
+        {
+            return m_ring.IsValid() && m_cursor.Read(m_ring, record, data, m_ring.DataSize());
+        }
+    };
+}
@@ -0,0 +1,261 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // Metadata stored alongside each report in a broadcast ring
+    struct ReportRecord
+    {
+        uint64_t Timestamp;
+        uint16_t VendorId;
+        uint16_t ProductId;
+        uint8_t Kind;         // DeviceKind
+        uint8_t ReportId;     // Report ID or GIP message ID
+        uint8_t MessageClass; // GIP message class, 0 otherwise
+        int8_t StateSlot;
+        uint16_t Length;      // Number of bytes stored, which is capped at the ring's data size
+        uint16_t FullLength;  // Length of the report as it was received
+        uint32_t Reserved;
+    };
+
+    // Fixed-size ring of reports with a single writer and any number of readers, each with their own cursor.
+    // The writer never waits on readers: a reader that falls more than a ring behind just loses the oldest reports.
+    // Every slot has a sequence number which is odd while the slot is being written and even once it's complete,
+    // so a reader can detect a slot that was overwritten while it was being copied and discard it.
+    // The ring only refers to memory owned by someone else, so it can be placed in shared memory and read
+    // by other processes, or in ordinary memory.
+    class BroadcastRing
+    {
+    public:
+        static constexpr uint32_t Magic = 0x52444757; // "WGDR"
+        static constexpr uint32_t Version = 1;
+
+    private:
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring sequences must be lock-free to be shared");
+
+        struct alignas(64) Header
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint32_t SlotCount; // Power of 2
+            uint32_t SlotSize;  // Stride between slots
+            uint32_t DataSize;  // Maximum report bytes per slot
+            uint32_t Reserved;
+            alignas(64) std::atomic<uint64_t> WriteSequence; // Number of reports ever published
+        };
+
+        struct Slot
+        {
+            std::atomic<uint64_t> Sequence; // 2n + 1 while report n is being written, 2n + 2 once written
+            ReportRecord Record;
+            // Followed by DataSize bytes of report data
+        };
+
+        Header* m_header = nullptr;
+        uint8_t* m_slots = nullptr;
+        uint64_t m_mask = 0;
+
+    public:
+        BroadcastRing() = default;
+
+        static size_t RequiredSize(uint32_t slotCount, uint32_t dataSize) noexcept
+        {
+            return sizeof(Header) + static_cast<size_t>(slotCount) * SlotSize(dataSize);
+        }
+
+        // Sets up a new ring over zero-filled memory. slotCount must be a power of 2.
+        bool Initialize(void* memory, size_t size, uint32_t slotCount, uint32_t dataSize) noexcept
+        {
+            if (!memory || slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || dataSize > UINT16_MAX ||
+                size < RequiredSize(slotCount, dataSize))
+            {
+                return false;
+            }
+
+            Header* header = static_cast<Header*>(memory);
+            header->Magic = Magic;
+            header->Version = Version;
+            header->SlotCount = slotCount;
+            header->SlotSize = static_cast<uint32_t>(SlotSize(dataSize));
+            header->DataSize = dataSize;
+            header->WriteSequence.store(0, std::memory_order_release);
+            return Attach(memory, size);
+        }
+
+        // Uses a ring which has already been initialized, such as one created by another process
+        bool Attach(void* memory, size_t size) noexcept
+        {
+            m_header = nullptr;
+            if (!memory || size < sizeof(Header))
+                return false;
+
+            Header* header = static_cast<Header*>(memory);
+            if (header->Magic != Magic || header->Version != Version ||
+                header->SlotCount == 0 || (header->SlotCount & (header->SlotCount - 1)) != 0 ||
+                header->SlotSize != SlotSize(header->DataSize) || size < RequiredSize(header->SlotCount, header->DataSize))
+            {
+                return false;
+            }
+
+            m_header = header;
+            m_slots = static_cast<uint8_t*>(memory) + sizeof(Header);
+            m_mask = header->SlotCount - 1;
+            return true;
+        }
+
+        bool IsValid() const noexcept { return m_header != nullptr; }
+        uint32_t SlotCount() const noexcept { return m_header->SlotCount; }
+        uint32_t DataSize() const noexcept { return m_header->DataSize; }
+
+        uint64_t WriteSequence() const noexcept
+        {
+            return m_header->WriteSequence.load(std::memory_order_acquire);
+        }
+
+        // Publishes a report, overwriting the oldest one. Must only ever be called by one thread at a time.
+        // Reports longer than the data size are truncated.
+        void Publish(ReportRecord record, const uint8_t* data, size_t length) noexcept
+        {
+            uint64_t sequence = m_header->WriteSequence.load(std::memory_order_relaxed);
+            Slot* slot = SlotAt(sequence);
+
+            slot->Sequence.store(sequence * 2 + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            record.FullLength = static_cast<uint16_t>(length < UINT16_MAX ? length : UINT16_MAX);
+            record.Length = static_cast<uint16_t>(length < m_header->DataSize ? length : m_header->DataSize);
+            memcpy(&slot->Record, &record, sizeof(record));
+            memcpy(SlotData(slot), data, record.Length);
+
+            slot->Sequence.store(sequence * 2 + 2, std::memory_order_release);
+            m_header->WriteSequence.store(sequence + 1, std::memory_order_release);
+        }
+
+        // Copies report n if it's still in the ring and wasn't overwritten during the copy.
+        // Up to capacity bytes of the report are copied into data.
+        bool TryRead(uint64_t sequence, ReportRecord& record, uint8_t* data, size_t capacity) const noexcept
+        {
+            const Slot* slot = SlotAt(sequence);
+            uint64_t before = slot->Sequence.load(std::memory_order_acquire);
+            if (before != sequence * 2 + 2)
+                return false;
+
+            memcpy(&record, &slot->Record, sizeof(record));
+            size_t length = record.Length < m_header->DataSize ? record.Length : m_header->DataSize;
+            memcpy(data, SlotData(slot), length < capacity ? length : capacity);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return slot->Sequence.load(std::memory_order_relaxed) == before;
+        }
+
+    private:
+        static size_t SlotSize(uint32_t dataSize) noexcept
+        {
+            // Rounded up so that every slot's sequence is aligned
+            return (sizeof(Slot) + dataSize + 15) & ~static_cast<size_t>(15);
+        }
+
+        Slot* SlotAt(uint64_t sequence) const noexcept
+        {
+            return reinterpret_cast<Slot*>(m_slots + (sequence & m_mask) * m_header->SlotSize);
+        }
+
+        static uint8_t* SlotData(Slot* slot) noexcept
+        {
+            return reinterpret_cast<uint8_t*>(slot + 1);
+        }
+
+        static const uint8_t* SlotData(const Slot* slot) noexcept
+        {
+            return reinterpret_cast<const uint8_t*>(slot + 1);
+        }
+    };
+
+    // A reader's position within a broadcast ring. Cursors are independent of each other and of the writer,
+    // so any number of them can read the same ring, each losing only the reports it fell too far behind on.
+    class BroadcastCursor
+    {
+    private:
+        uint64_t m_next = 0;
+        uint64_t m_lost = 0;
+
+    public:
+        // Starts at the oldest report still in the ring, or only at reports published from now on
+        void Reset(BroadcastRing const& ring, bool fromNow) noexcept
+        {
+            uint64_t write = ring.WriteSequence();
+            if (fromNow)
+                m_next = write;
+            else
+                m_next = write > ring.SlotCount() ? write - ring.SlotCount() : 0;
+            m_lost = 0;
+        }
+
+        // Number of reports skipped because they were overwritten before they could be read
+        uint64_t Lost() const noexcept { return m_lost; }
+
+        // Number of reports published but not read yet, including ones that will be lost
+        uint64_t Lag(BroadcastRing const& ring) const noexcept
+        {
+            uint64_t write = ring.WriteSequence();
+            return write > m_next ? write - m_next : 0;
+        }
+
+        // Reads the next report, returning false once caught up with the writer
+        bool Read(BroadcastRing const& ring, ReportRecord& record, uint8_t* data, size_t capacity) noexcept
+        {
+            while (true)
+            {
+                uint64_t write = ring.WriteSequence();
+                if (m_next >= write)
+                    return false;
+
+                // Jump over anything the writer has already lapped
+                if (write - m_next > ring.SlotCount())
+                {
+                    uint64_t oldest = write - ring.SlotCount();
+                    m_lost += oldest - m_next;
+                    m_next = oldest;
+                }
+
+                uint64_t sequence = m_next++;
+                if (ring.TryRead(sequence, record, data, capacity))
+                    return true;
+
+                m_lost++;
+            }
+        }
+    };
+
+    // A broadcast ring in ordinary memory, for sharing reports between threads of the same process
+    class LocalBroadcastRing
+    {
+    private:
+        std::vector<uint8_t> m_memory;
+        BroadcastRing m_ring;
+
+    public:
+        LocalBroadcastRing(uint32_t slotCount, uint32_t dataSize)
+        {
+            // Padded so the ring can start on a cache line
+            size_t size = BroadcastRing::RequiredSize(slotCount, dataSize);
+            m_memory.resize(size + 64);
+
+            void* memory = m_memory.data();
+            size_t space = m_memory.size();
+            std::align(64, size, memory, space);
+            m_ring.Initialize(memory, size, slotCount, dataSize);
+        }
+
+        LocalBroadcastRing(LocalBroadcastRing const&) = delete;
+        LocalBroadcastRing& operator=(LocalBroadcastRing const&) = delete;
+
+        BroadcastRing& Ring() noexcept { return m_ring; }
+        BroadcastRing const& Ring() const noexcept { return m_ring; }
+    };
+}
@@ -0,0 +1,387 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // Tracks the buffer memory held by one owner, such as a device, against an optional limit
+    class BufferAccount
+    {
+    private:
+        std::atomic<uint64_t> m_used { 0 };
+        std::atomic<uint64_t> m_peak { 0 };
+        std::atomic<uint64_t> m_limit;
+        std::atomic<uint64_t> m_failed { 0 };
+
+    public:
+        // A limit of 0 means unlimited
+        explicit BufferAccount(uint64_t limit = 0) noexcept
+            : m_limit(limit)
+        {
+        }
+
+        uint64_t Used() const noexcept { return m_used.load(std::memory_order_relaxed); }
+        uint64_t Peak() const noexcept { return m_peak.load(std::memory_order_relaxed); }
+        uint64_t Limit() const noexcept { return m_limit.load(std::memory_order_relaxed); }
+        uint64_t FailedAllocations() const noexcept { return m_failed.load(std::memory_order_relaxed); }
+
+        // Takes effect for later allocations; memory already held isn't given back
+        void SetLimit(uint64_t limit) noexcept { m_limit.store(limit, std::memory_order_relaxed); }
+        void ResetPeak() noexcept { m_peak.store(Used(), std::memory_order_relaxed); }
+
+        void Release(uint64_t bytes) noexcept
+        {
+            m_used.fetch_sub(bytes, std::memory_order_relaxed);
+        }
+
+        // Charges bytes if that keeps the account within its limit
+        bool TryCharge(uint64_t bytes) noexcept
+        {
+            uint64_t limit = Limit();
+            uint64_t used = m_used.load(std::memory_order_relaxed);
+            do
+            {
+                if (limit != 0 && used + bytes > limit)
+                {
+                    m_failed.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            } while (!m_used.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+            Raise(m_peak, used + bytes);
+            return true;
+        }
+
+        void CountFailure() noexcept
+        {
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        static void Raise(std::atomic<uint64_t>& peak, uint64_t value) noexcept
+        {
+            uint64_t current = peak.load(std::memory_order_relaxed);
+            while (current < value && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+    };
+
+    class BufferPool;
+
+    // A buffer from a BufferPool, returned to it when destroyed. Stands in for a byte array, so it has the same
+    // data() and size() as one.
+    class PooledBuffer
+    {
+    private:
+        friend class BufferPool;
+
+        BufferPool* m_pool = nullptr;
+        std::shared_ptr<BufferAccount> m_account;
+        uint8_t* m_data = nullptr;
+        uint32_t m_size = 0;
+        uint32_t m_capacity = 0;
+
+    public:
+        PooledBuffer() = default;
+        PooledBuffer(PooledBuffer const&) = delete;
+        PooledBuffer& operator=(PooledBuffer const&) = delete;
+
+        PooledBuffer(PooledBuffer&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+
+        ~PooledBuffer();
+
+        uint8_t* data() noexcept { return m_data; }
+        const uint8_t* data() const noexcept { return m_data; }
+        uint32_t size() const noexcept { return m_size; }
+        uint32_t Capacity() const noexcept { return m_capacity; }
+
+        // Changes the size without reallocating, returning false if it doesn't fit in the capacity.
+        // The contents are kept up to the new size.
+        bool Resize(uint32_t size) noexcept
+        {
+            if (size > m_capacity)
+                return false;
+
+            m_size = size;
+            return true;
+        }
+
+        void Reset() noexcept;
+    };
+
+    // Hands out report and message buffers from slabs divided into power-of-2 size classes, with buffers larger than
+    // the largest class allocated individually. Every buffer is charged to the account it was allocated for, and to
+    // the pool as a whole, and allocation fails rather than go over either limit. Each thread keeps a small cache of
+    // free buffers per class for the global pool, so allocating and freeing only takes the pool's lock once per batch.
+    // Slabs are kept for reuse rather than freed.
+    class BufferPool
+    {
+    public:
+        static constexpr uint32_t MinClassSize = 32;
+        static constexpr size_t ClassCount = 8; // Up to 4096 bytes
+        static constexpr size_t SlabSize = 64 * 1024;
+        static constexpr size_t ThreadCacheSize = 16;
+
+        struct Statistics
+        {
+            uint64_t Used;       // Bytes of buffers held, by capacity
+            uint64_t Peak;
+            uint64_t Limit;
+            uint64_t Reserved;   // Bytes of slabs and individually allocated buffers
+            uint64_t Buffers;    // Buffers held
+            uint64_t FailedAllocations;
+        };
+
+    private:
+        static constexpr size_t LargeClass = ClassCount;
+
+        // Fixed-size, so that freeing a buffer never has to allocate
+        struct CachedBlocks
+        {
+            uint8_t* Blocks[ThreadCacheSize + 1];
+            size_t Count = 0;
+        };
+
+        struct ThreadCache
+        {
+            CachedBlocks Free[ClassCount];
+
+            ~ThreadCache()
+            {
+                s_cacheDestroyed = true;
+                for (size_t sizeClass = 0; sizeClass < ClassCount; sizeClass++)
+                    Global().ReturnBatch(sizeClass, Free[sizeClass], Free[sizeClass].Count);
+            }
+        };
+
+        // Buffers freed as a thread exits, after its cache is gone, go straight back to the pool
+        static inline thread_local bool s_cacheDestroyed = false;
+
+        std::mutex m_lock;
+        std::vector<std::unique_ptr<uint8_t[]>> m_slabs;
+        // Each reserves room for every block carved for its class, so giving blocks back never allocates
+        std::vector<uint8_t*> m_free[ClassCount];
+        size_t m_carved[ClassCount] {};
+
+        BufferAccount m_total;
+        std::atomic<uint64_t> m_reserved { 0 };
+        std::atomic<uint64_t> m_buffers { 0 };
+
+    public:
+        explicit BufferPool(uint64_t limit = 0)
+            : m_total(limit)
+        {
+        }
+
+        BufferPool(BufferPool const&) = delete;
+        BufferPool& operator=(BufferPool const&) = delete;
+
+        // Shared by all devices, and the only pool that uses thread caches. Never destroyed, since thread caches
+        // can still give buffers back to it during shutdown.
+        static BufferPool& Global()
+        {
+            static BufferPool* pool = new BufferPool(16 * 1024 * 1024);
+            return *pool;
+        }
+
+        void SetLimit(uint64_t limit) noexcept { m_total.SetLimit(limit); }
+        void ResetPeak() noexcept { m_total.ResetPeak(); }
+
+        Statistics GetStatistics() const noexcept
+        {
+            return {
+                m_total.Used(),
+                m_total.Peak(),
+                m_total.Limit(),
+                m_reserved.load(std::memory_order_relaxed),
+                m_buffers.load(std::memory_order_relaxed),
+                m_total.FailedAllocations()
+            };
+        }
+
+        // Returns an empty buffer if the account or the pool would go over its limit
+        PooledBuffer Allocate(std::shared_ptr<BufferAccount> const& account, uint32_t size)
+        {
+            PooledBuffer buffer;
+            size_t sizeClass = ClassOf(size);
+            uint32_t capacity = sizeClass == LargeClass ? size : ClassSize(sizeClass);
+
+            if (!account->TryCharge(capacity))
+                return buffer;
+
+            if (!m_total.TryCharge(capacity))
+            {
+                account->Release(capacity);
+                account->CountFailure();
+                return buffer;
+            }
+
+            buffer.m_data = sizeClass == LargeClass ? AllocateLarge(size) : Take(sizeClass);
+            buffer.m_pool = this;
+            buffer.m_account = account;
+            buffer.m_size = size;
+            buffer.m_capacity = capacity;
+            m_buffers.fetch_add(1, std::memory_order_relaxed);
+            return buffer;
+        }
+
+    private:
+        friend class PooledBuffer;
+
+        static size_t ClassOf(uint32_t size) noexcept
+        {
+            uint32_t classSize = MinClassSize;
+            for (size_t sizeClass = 0; sizeClass < ClassCount; sizeClass++, classSize <<= 1)
+            {
+                if (size <= classSize)
+                    return sizeClass;
+            }
+
+            return LargeClass;
+        }
+
+        static uint32_t ClassSize(size_t sizeClass) noexcept
+        {
+            return MinClassSize << sizeClass;
+        }
+
+        static ThreadCache& Cache()
+        {
+            static thread_local ThreadCache cache;
+            return cache;
+        }
+
+        uint8_t* AllocateLarge(uint32_t size)
+        {
+            m_reserved.fetch_add(size, std::memory_order_relaxed);
+            return new uint8_t[size];
+        }
+
+        bool UsesThreadCache() const
+        {
+            return this == &Global() && !s_cacheDestroyed;
+        }
+
+        uint8_t* Take(size_t sizeClass)
+        {
+            if (!UsesThreadCache())
+            {
+                uint8_t* block;
+                TakeBatch(sizeClass, &block, 1);
+                return block;
+            }
+
+            auto& free = Cache().Free[sizeClass];
+            if (free.Count == 0)
+            {
+                TakeBatch(sizeClass, free.Blocks, ThreadCacheSize / 2);
+                free.Count = ThreadCacheSize / 2;
+            }
+
+            return free.Blocks[--free.Count];
+        }
+
+        void Free(uint8_t* data, uint32_t capacity, BufferAccount& account) noexcept
+        {
+            account.Release(capacity);
+            m_total.Release(capacity);
+            m_buffers.fetch_sub(1, std::memory_order_relaxed);
+
+            size_t sizeClass = ClassOf(capacity);
+            if (sizeClass == LargeClass)
+            {
+                m_reserved.fetch_sub(capacity, std::memory_order_relaxed);
+                delete[] data;
+                return;
+            }
+
+            if (!UsesThreadCache())
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_free[sizeClass].push_back(data);
+                return;
+            }
+
+            // A full cache gives half of itself back, so a thread alternating between allocating and freeing
+            // doesn't go to the pool every time
+            auto& free = Cache().Free[sizeClass];
+            free.Blocks[free.Count++] = data;
+            if (free.Count > ThreadCacheSize)
+                ReturnBatch(sizeClass, free, ThreadCacheSize / 2);
+        }
+
+        // Copies count free blocks into blocks, carving up a new slab if there aren't enough
+        void TakeBatch(size_t sizeClass, uint8_t** blocks, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto& free = m_free[sizeClass];
+            if (free.size() < count)
+            {
+                size_t blockSize = ClassSize(sizeClass);
+                free.reserve(m_carved[sizeClass] + SlabSize / blockSize);
+                m_slabs.push_back(std::make_unique<uint8_t[]>(SlabSize));
+                m_reserved.fetch_add(SlabSize, std::memory_order_relaxed);
+                m_carved[sizeClass] += SlabSize / blockSize;
+                for (size_t offset = 0; offset + blockSize <= SlabSize; offset += blockSize)
+                    free.push_back(m_slabs.back().get() + offset);
+            }
+
+            std::copy(free.end() - count, free.end(), blocks);
+            free.resize(free.size() - count);
+        }
+
+        // Moves the last count cached blocks back to the pool
+        void ReturnBatch(size_t sizeClass, CachedBlocks& blocks, size_t count) noexcept
+        {
+            if (count == 0)
+                return;
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            blocks.Count -= count;
+            m_free[sizeClass].insert(m_free[sizeClass].end(), blocks.Blocks + blocks.Count, blocks.Blocks + blocks.Count + count);
+        }
+    };
+
+    inline PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            m_pool = std::exchange(other.m_pool, nullptr);
+            m_account = std::move(other.m_account);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+        }
+
+        return *this;
+    }
+
+    inline PooledBuffer::~PooledBuffer()
+    {
+        Reset();
+    }
+
+    inline void PooledBuffer::Reset() noexcept
+    {
+        if (m_pool)
+            m_pool->Free(m_data, m_capacity, *m_account);
+
+        m_pool = nullptr;
+        m_account.reset();
+        m_data = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+}
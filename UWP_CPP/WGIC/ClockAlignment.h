@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // Host time used for clock alignment: the steady clock (QueryPerformanceCounter on Windows) in microseconds
+    inline uint64_t HostMicroseconds() noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    // Estimates how a device's report timestamps map onto host time, from the host time each report arrived at.
+    // Arrival times are the device time plus a delay that varies from report to report, so within each bucket of
+    // device time only the earliest-arriving report is kept. A line is fitted through those, leaving out buckets
+    // whose reports were all held up (such as by a stalled thread), to give the rate and offset of the device clock.
+    // Aligned times are therefore when a report would have arrived with the least delay seen, not when the device
+    // produced it; what matters for comparing devices and frames is that the offset is consistent.
+    class ClockEstimator
+    {
+    private:
+        struct Sample
+        {
+            uint64_t Device;
+            uint64_t Host;
+        };
+
+        uint64_t m_bucketLength;
+        size_t m_capacity;
+        std::vector<Sample> m_buckets; // Oldest first
+        bool m_hasBucket = false;
+        Sample m_current {};         // Earliest-arriving sample of the bucket being filled
+        uint64_t m_bucketStart = 0;
+        uint64_t m_lastDevice = 0;
+
+        // host = m_hostOrigin + m_offset + m_rate * (device - m_deviceOrigin)
+        bool m_fitted = false;
+        uint64_t m_deviceOrigin = 0;
+        uint64_t m_hostOrigin = 0;
+        double m_offset = 0;
+        double m_rate = 1;
+        double m_jitter = 0;
+        size_t m_inliers = 0;
+
+    public:
+        // Keeps bucketCount buckets of bucketLength device microseconds each; the defaults fit over about 6 seconds
+        explicit ClockEstimator(uint64_t bucketLength = 100000, size_t bucketCount = 64)
+            : m_bucketLength(std::max<uint64_t>(bucketLength, 1)), m_capacity(std::max<size_t>(bucketCount, 3))
+        {
+            m_buckets.reserve(m_capacity);
+        }
+
+        void Reset() noexcept
+        {
+            m_buckets.clear();
+            m_hasBucket = false;
+            m_fitted = false;
+            m_rate = 1;
+            m_offset = 0;
+            m_jitter = 0;
+            m_inliers = 0;
+        }
+
+        void AddSample(uint64_t device, uint64_t host)
+        {
+            // The device's time base was reset, such as after reconnecting
+            if (m_hasBucket && device < m_lastDevice)
+                Reset();
+            m_lastDevice = device;
+
+            if (!m_hasBucket)
+            {
+                StartBucket(device, host);
+                return;
+            }
+
+            if (device - m_bucketStart >= m_bucketLength)
+            {
+                if (m_buckets.size() == m_capacity)
+                    m_buckets.erase(m_buckets.begin());
+                m_buckets.push_back(m_current);
+                Fit();
+                StartBucket(device, host);
+                return;
+            }
+
+            if (Delay(device, host) < Delay(m_current.Device, m_current.Host))
+                m_current = { device, host };
+        }
+
+        uint64_t ToHost(uint64_t device) const noexcept
+        {
+            if (!m_hasBucket)
+                return device;
+
+            if (!m_fitted)
+            {
+                // Not enough history for a rate yet, so assume the clocks run at the same speed
+                double host = static_cast<double>(m_current.Host) + (static_cast<double>(device) - m_current.Device);
+                return host > 0 ? static_cast<uint64_t>(host) : 0;
+            }
+
+            double host = m_hostOrigin + m_offset + m_rate * (static_cast<double>(device) - static_cast<double>(m_deviceOrigin));
+            return host > 0 ? static_cast<uint64_t>(std::llround(host)) : 0;
+        }
+
+        bool Fitted() const noexcept { return m_fitted; }
+
+        // Host microseconds per device microsecond
+        double Rate() const noexcept { return m_rate; }
+
+        // How much faster the device clock runs than the host clock
+        double DriftPpm() const noexcept { return (1 / m_rate - 1) * 1e6; }
+
+        // Typical distance of the kept samples from the fit, in microseconds
+        double Jitter() const noexcept { return m_jitter; }
+
+        // Number of buckets the current fit is based on
+        size_t Samples() const noexcept { return m_inliers; }
+
+    private:
+        void StartBucket(uint64_t device, uint64_t host) noexcept
+        {
+            m_hasBucket = true;
+            m_bucketStart = device;
+            m_current = { device, host };
+        }
+
+        static int64_t Delay(uint64_t device, uint64_t host) noexcept
+        {
+            return static_cast<int64_t>(host - device);
+        }
+
+        void Fit()
+        {
+            if (m_buckets.size() < 3)
+                return;
+
+            // Relative to the newest bucket, to keep the values small enough to stay precise as doubles
+            uint64_t deviceOrigin = m_buckets.back().Device;
+            uint64_t hostOrigin = m_buckets.back().Host;
+            std::vector<double> x(m_buckets.size());
+            std::vector<double> y(m_buckets.size());
+            std::vector<bool> inlier(m_buckets.size(), true);
+            for (size_t i = 0; i < m_buckets.size(); i++)
+            {
+                x[i] = static_cast<double>(static_cast<int64_t>(m_buckets[i].Device - deviceOrigin));
+                y[i] = static_cast<double>(static_cast<int64_t>(m_buckets[i].Host - hostOrigin));
+            }
+
+            // Start from the last rate, or equal rates, so a run of held-up buckets can't tilt the first line.
+            // Each pass leaves out buckets far from the line by the median absolute deviation and fits again.
+            double rate = m_fitted ? m_rate : 1;
+            double offset = 0;
+            size_t inliers = 0;
+            std::vector<double> residuals(x.size());
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (size_t i = 0; i < x.size(); i++)
+                    residuals[i] = y[i] - (offset + rate * x[i]);
+
+                double median = Median(residuals);
+                std::vector<double> deviations(residuals.size());
+                for (size_t i = 0; i < residuals.size(); i++)
+                    deviations[i] = std::abs(residuals[i] - median);
+                double limit = std::max(3 * 1.4826 * Median(deviations), 1.0);
+
+                inliers = 0;
+                for (size_t i = 0; i < x.size(); i++)
+                {
+                    inlier[i] = deviations[i] <= limit;
+                    inliers += inlier[i];
+                }
+
+                if (inliers < 3 || !Regress(x, y, inlier, offset, rate))
+                    return;
+            }
+
+            double spread = 0;
+            for (size_t i = 0; i < x.size(); i++)
+            {
+                if (inlier[i])
+                    spread += std::abs(y[i] - (offset + rate * x[i]));
+            }
+
+            m_fitted = true;
+            m_deviceOrigin = deviceOrigin;
+            m_hostOrigin = hostOrigin;
+            m_offset = offset;
+            m_rate = rate;
+            m_jitter = spread / inliers;
+            m_inliers = inliers;
+        }
+
+        static bool Regress(std::vector<double> const& x, std::vector<double> const& y, std::vector<bool> const& inlier,
+            double& offset, double& rate)
+        {
+            double n = 0, sumX = 0, sumY = 0;
+            for (size_t i = 0; i < x.size(); i++)
+            {
+                if (!inlier[i])
+                    continue;
+
+                n++;
+                sumX += x[i];
+                sumY += y[i];
+            }
+
+            double meanX = sumX / n;
+            double meanY = sumY / n;
+            double covariance = 0, variance = 0;
+            for (size_t i = 0; i < x.size(); i++)
+            {
+                if (!inlier[i])
+                    continue;
+
+                covariance += (x[i] - meanX) * (y[i] - meanY);
+                variance += (x[i] - meanX) * (x[i] - meanX);
+            }
+
+            if (n < 2 || variance <= 0)
+                return false;
+
+            rate = covariance / variance;
+            offset = meanY - rate * meanX;
+            return true;
+        }
+
+        static double Median(std::vector<double> values)
+        {
+            size_t middle = values.size() / 2;
+            std::nth_element(values.begin(), values.begin() + middle, values.end());
+            return values[middle];
+        }
+    };
+}
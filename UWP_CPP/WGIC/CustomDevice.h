@@ -1,12 +1,26 @@
 #pragma once
 #include "pch.h"
+#include "WGIC/AsyncSignal.h"
+#include "WGIC/BufferPool.h"
+#include "WGIC/ClockAlignment.h"
 #include "WGIC/DeviceFactory.h"
+#include "WGIC/DeviceLifecycle.h"
+#include "WGIC/FlightRecorder.h"
+#include "WGIC/IdleDetector.h"
+#include "WGIC/ReportArchive.h"
+#include "WGIC/ReportExporter.h"
+#include "WGIC/ReportQueue.h"
+#include "WGIC/ReportStreamServer.h"
+#include "WGIC/ReportSubscription.h"
+#include "WGIC/StateHistory.h"
 #include "WGIC/VectorCollection.h"
+#include "WGIC/InputEventMapper.h"
+#include "WGIC/TickResampler.h"
 
 namespace winrt::WGIC
 {
     template<typename D, typename TDevice, typename... I>
-    using CustomDeviceT = winrt::implements<D, TDevice, Custom::IGameControllerInputSink,
+    using CustomDeviceT = winrt::implements<D, TDevice, WGIC::ICustomDevice, Custom::IGameControllerInputSink,
         winrt::cloaked<Custom::IAggregable>, I...>;
     // Cloaking the IAggregable interface is optional, all it does is keep it from being listed in GetIids.
 
@@ -18,12 +32,22 @@ namespace winrt::WGIC
         // used. C++/WinRT provides the winrt::composing marker type for this, however that is also ignored since there
         // are some unfortunate infinite loop issues that require this to be handled manually.
 
+    public:
+        using device_type = TDevice;
+        using provider_type = TProvider;
+
     protected:
         static inline Collections::IVector<TDevice> s_devices = winrt::make<WGIC::VectorCollection<TDevice>>();
         static inline std::mutex s_devicesLock {};
         static inline winrt::event<Foundation::EventHandler<TDevice>> s_deviceAdded {};
         static inline winrt::event<Foundation::EventHandler<TDevice>> s_deviceRemoved {};
 
+        // Input maps are keyed by (vendorId << 16) | productId
+        static inline std::unordered_map<uint32_t, std::shared_ptr<const Core::InputMap>> s_inputMaps {};
+        static inline std::mutex s_inputMapsLock {};
+        // Bumped on every registration, so devices only need to look their map up again when it changes
+        static inline std::atomic<uint32_t> s_inputMapsGeneration { 0 };
+
     public:
         static Collections::IVectorView<TDevice> Devices()
         {
@@ -51,48 +75,90 @@ namespace winrt::WGIC
             s_deviceRemoved.remove(token);
         }
 
-        static void AddDevice(TDevice const& device)
+        // Adds the device to Devices, returning false if it was already listed. The caller raises DeviceAdded
+        // afterwards, once it holds no locks, since subscribers may get the device list in their handlers.
+        static bool ListDevice(TDevice const& device)
         {
-            if (!device)
-                return;
+            std::lock_guard<std::mutex> lock(s_devicesLock);
+            uint32_t index = 0;
+            if (!device || s_devices.IndexOf(device, index))
+                return false;
 
-            // New scope is done to prevent deadlocking if the
-            // event subscriber gets the device list in the event handler
-            bool fireEvent = false;
-            {
-                std::lock_guard<std::mutex> lock(s_devicesLock);
-                uint32_t index = 0;
-                if (!s_devices.IndexOf(device, index))
+            s_devices.Append(device);
+            return true;
+        }
+
+        // Removes the device from Devices, returning false if it wasn't listed
+        static bool UnlistDevice(TDevice const& device)
+        {
+            std::lock_guard<std::mutex> lock(s_devicesLock);
+            uint32_t index = 0;
+            if (!device || !s_devices.IndexOf(device, index))
+                return false;
+
+            s_devices.RemoveAt(index);
+            return true;
+        }
+
+        // Runs everything that happens when a device connects. This is done on DeviceFactory::InitWorkers() rather
+        // than the thread the connection was reported on, so that devices connected together are set up in parallel.
+        // The device is only listed, and DeviceAdded raised, once it's ready.
+        static void ConnectDevice(TDevice const& device)
+        {
+            auto self = winrt::get_self<D>(device);
+            auto logger = spdlog::get(s_loggerName)->clone("CustomDevice::ConnectDevice");
+            Utilities::LogIInspectable(logger, self->m_provider);
+            Utilities::LogIInspectable(logger, device);
+
+            // The lifecycle only lists the device under its lock; events and signals are raised after releasing it,
+            // since their handlers and the waiters they resume can run anything
+            bool connected = self->m_lifecycle.Connect(
+                [&] { return ListDevice(device); },
+                [&]
                 {
-                    fireEvent = true;
-                    s_devices.Append(device);
-                }
+                    s_deviceAdded(nullptr, device);
+                    DeviceFactory::DevicesChanged().Notify();
+                },
+                [&]
+                {
+                    s_deviceRemoved(nullptr, device);
+                    DeviceFactory::DevicesChanged().Notify();
+                });
+
+            if (!connected)
+            {
+                logger->debug("Device was removed before it was ready");
+                return;
             }
 
-            if (fireEvent)
-                s_deviceAdded(nullptr, device);
+            self->m_readySignal.Notify();
         }
 
-        static void RemoveDevice(TDevice const& device)
+        // Runs on the thread the disconnection was reported on
+        static void DisconnectDevice(TDevice const& device)
         {
-            if (!device)
-                return;
+            auto self = winrt::get_self<D>(device);
+            bool unlisted = self->m_lifecycle.Remove([&] { return UnlistDevice(device); });
+
+            // The slot is freed here rather than when the device is destroyed, since references may outlive the connection
+            self->ReleaseStateSlot();
 
-            // New scope is done to prevent deadlocking if the
-            // event subscriber gets the device list in the event handler
-            bool fireEvent = false;
+            // Wake anything waiting for a report, or for the device to be ready, so it can see that the device is gone
+            self->NotifyReport();
+            if (unlisted)
             {
-                std::lock_guard<std::mutex> lock(s_devicesLock);
-                uint32_t index = 0;
-                if (s_devices.IndexOf(device, index))
-                {
-                    fireEvent = true;
-                    s_devices.RemoveAt(index);
-                }
+                s_deviceRemoved(nullptr, device);
+                DeviceFactory::DevicesChanged().Notify();
             }
+            self->m_readySignal.Notify();
+        }
 
-            if (fireEvent)
-                s_deviceRemoved(nullptr, device);
+        // Gives up on a device whose setup failed, waking anything waiting for it to be ready to find that it isn't
+        static void AbandonDevice(TDevice const& device)
+        {
+            auto self = winrt::get_self<D>(device);
+            self->m_lifecycle.Abandon();
+            self->m_readySignal.Notify();
         }
 
         static TDevice FromGameController(Input::IGameController const& gameController)
@@ -100,39 +166,340 @@ namespace winrt::WGIC
             return DeviceFactory::FromGameController<TDevice>(gameController);
         }
 
+        // Registers the control layout used to generate input events for a device.
+        // The layout is compiled here, and connected devices switch over to it on their next report.
+        static void RegisterInputMap(uint16_t vendorId, uint16_t productId,
+            winrt::array_view<WGIC::InputControlMapping const> mappings)
+        {
+            Core::MappingList list;
+            list.reserve(mappings.size());
+            for (auto const& mapping : mappings)
+            {
+                list.push_back({
+                    static_cast<Core::ControlType>(mapping.Type),
+                    mapping.ReportId,
+                    mapping.Offset,
+                    mapping.Bit,
+                    mapping.Size,
+                    mapping.Signed,
+                    mapping.Threshold,
+                    mapping.Control,
+                    static_cast<Core::ControlTransform>(mapping.Transform)
+                });
+            }
+
+            auto inputMap = std::make_shared<const Core::InputMap>(std::move(list));
+
+            std::lock_guard<std::mutex> lock(s_inputMapsLock);
+            s_inputMaps[(static_cast<uint32_t>(vendorId) << 16) | productId] = std::move(inputMap);
+            s_inputMapsGeneration.fetch_add(1, std::memory_order_release);
+        }
+
     private:
         Foundation::IInspectable m_innerObject { nullptr };
 
     protected:
+        static constexpr uint32_t s_broadcastSlots = 64;
+        static constexpr uint32_t s_broadcastReportSize = 256;
+        static constexpr size_t s_reportQueueSize = 64 * 1024;
+        // Reports processed per turn on a worker, so a busy device doesn't keep its worker from other devices
+        static constexpr size_t s_reportBatchSize = 64;
+        // Lock-free tries at copying a history range before GetHistoryRange holds off the worker instead
+        static constexpr int s_historyReadAttempts = 4;
+
         TProvider m_provider;
+        WGIC::DeviceDescriptor m_descriptor;
 
+        // Guards the current report, which the input sinks update directly
         std::mutex m_readingLock;
         bool m_inputSuspended;
+        Core::IdleDetector m_idleDetector;
+        // The earliest-arriving report the idle detector skipped since the last one was queued, handed over with
+        // the next queued report so the clock estimate isn't limited to one arrival per heartbeat while idle
+        uint64_t m_skippedTimestamp = 0;
+        uint64_t m_skippedArrivalTime = 0;
+
+        // Charged for the current report's buffer, which comes from DeviceFactory::Buffers()
+        std::shared_ptr<Core::BufferAccount> m_bufferAccount;
+
+        // Reports are processed on DeviceFactory::Workers() rather than in the input sinks
+        std::shared_ptr<Core::ReportQueue> m_reportQueue;
+        std::mutex m_processingLock;
+
+        // Guarded by m_processingLock
+        Core::EventMapper m_eventMapper;
+        Core::EventQueue m_eventQueue { 256 };
+        int32_t m_stateSlot = -1;
+        Core::TickResampler m_resampler;
+        Core::ClockEstimator m_clock;
+        uint32_t m_inputMapGeneration = 0;
+        // Created by the first subscriber, IngestReport is its only writer
+        std::shared_ptr<Core::LocalBroadcastRing> m_broadcast;
+
+        Core::AsyncSignal m_reportSignal;
+
+        Core::DeviceLifecycle m_lifecycle;
+        Core::AsyncSignal m_readySignal;
+
+        // Written by EnableHistory with m_processingLock held, but read by the history methods without it
+        std::shared_ptr<Core::StateHistory> m_history;
+        // Written by EnableArchive with m_processingLock held
+        std::shared_ptr<Core::ReportArchive> m_archive;
+
+        // Makes a buffer hold size bytes, only taking a new one from the pool if it doesn't fit, in which case the
+        // contents are lost. Returns false if this device or the pool is at its limit.
+        bool ResizeBuffer(Core::PooledBuffer& buffer, uint32_t size)
+        {
+            if (buffer.Resize(size))
+                return true;
+
+            auto resized = DeviceFactory::Buffers().Allocate(m_bufferAccount, size);
+            if (!resized.data())
+                return false;
+
+            buffer = std::move(resized);
+            return true;
+        }
+
+        // Hands a newly-received report over to be processed, unless the device is idle and it's just another
+        // unchanged report. Must be called from the input sinks with m_readingLock held, which keeps the queue to
+        // a single producer.
+        void QueueReport(uint64_t timestamp, uint8_t reportId, winrt::array_view<uint8_t const> data, uint64_t changeMask,
+            uint8_t messageClass = 0)
+        {
+            // Taken before filtering, since the clock estimate relies on the least-delayed arrivals, and those are
+            // as likely to be among the skipped reports as not
+            uint64_t arrivalTime = Core::HostMicroseconds();
+            if (!m_idleDetector.Filter(timestamp, changeMask))
+            {
+                if (m_skippedArrivalTime == 0 ||
+                    static_cast<int64_t>(arrivalTime - timestamp) < static_cast<int64_t>(m_skippedArrivalTime - m_skippedTimestamp))
+                {
+                    m_skippedTimestamp = timestamp;
+                    m_skippedArrivalTime = arrivalTime;
+                }
+                return;
+            }
+
+            Core::QueuedReport report { timestamp, arrivalTime, m_skippedTimestamp, m_skippedArrivalTime, changeMask,
+                data.size(), reportId, messageClass, 0 };
+            if (m_reportQueue->Push(report, data.data()))
+                m_skippedArrivalTime = 0;
+        }
+
+        // Runs on a worker with this device's queued reports
+        void ProcessQueuedReports(Core::ReportQueue& queue)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_processingLock);
+                Core::QueuedReport report;
+                const uint8_t* data;
+                for (size_t i = 0; i < s_reportBatchSize && queue.Front(report, data); i++)
+                {
+                    if (report.SkippedArrivalTime != 0)
+                        m_clock.AddSample(report.SkippedTimestamp, report.SkippedArrivalTime);
+                    m_clock.AddSample(report.Timestamp, report.ArrivalTime);
+                    IngestReport(report.Timestamp, report.ReportId, winrt::array_view<uint8_t const>(data, data + report.Length),
+                        report.ChangeMask, report.MessageClass);
+                    queue.Pop();
+                }
+            }
+
+            // Waiters resumed here may release the last reference to this device, so nothing can come after it
+            NotifyReport();
+        }
+
+        // Runs the processing shared by all device kinds on a report. Must be called with m_processingLock held.
+        void IngestReport(uint64_t timestamp, uint8_t reportId, winrt::array_view<uint8_t const> data, uint64_t changeMask,
+            uint8_t messageClass = 0)
+        {
+            Core::ReportRecord record {};
+            record.Timestamp = timestamp;
+            record.VendorId = m_descriptor.VendorId;
+            record.ProductId = m_descriptor.ProductId;
+            record.Kind = static_cast<uint8_t>(m_descriptor.Kind);
+            record.ReportId = reportId;
+            record.MessageClass = messageClass;
+            record.StateSlot = static_cast<int8_t>(m_stateSlot);
+            implementation::FlightRecorder::Publish(record, data);
+            implementation::ReportExporter::Publish(record, data);
+            implementation::ReportStreamServer::Publish(record, data);
+            if (m_broadcast)
+                m_broadcast->Ring().Publish(record, data.data(), data.size());
+            if (m_archive)
+                m_archive->Append(timestamp, reportId, data.data(), data.size());
+
+            // A single atomic load per report; the map lock is only taken after a registration
+            if (m_inputMapGeneration != s_inputMapsGeneration.load(std::memory_order_acquire))
+                RefreshInputMap();
+
+            m_eventMapper.Process(timestamp, reportId, data.data(), data.size(), changeMask, m_eventQueue);
+            DeviceFactory::States().Update(m_stateSlot, timestamp, m_eventMapper);
+
+            if (m_resampler.Enabled() || m_history)
+            {
+                Core::ControlState state {};
+                m_eventMapper.WriteState(state.Buttons, state.Axes, Core::AxesPerDevice, state.Hats, Core::HatsPerDevice);
+                if (m_resampler.Enabled())
+                    m_resampler.AddSample(timestamp, state);
+                if (m_history)
+                    m_history->Append(timestamp, state);
+            }
+        }
+
+        // Resumes anything waiting for the next report. Must be called after releasing m_processingLock,
+        // since waiters may be resumed inline and read the report's results straight away.
+        void NotifyReport()
+        {
+            m_reportSignal.Notify();
+        }
+
+        // Must be called with m_processingLock held, or from the constructor
+        void RefreshInputMap()
+        {
+            std::lock_guard<std::mutex> lock(s_inputMapsLock);
+            m_inputMapGeneration = s_inputMapsGeneration.load(std::memory_order_relaxed);
+
+            auto inputMap = s_inputMaps.find((static_cast<uint32_t>(m_descriptor.VendorId) << 16) | m_descriptor.ProductId);
+            if (inputMap != s_inputMaps.end() && inputMap->second != m_eventMapper.Map())
+                m_eventMapper = Core::EventMapper(inputMap->second);
+        }
+
+        void ReleaseStateSlot()
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            DeviceFactory::States().ReleaseSlot(m_stateSlot);
+            m_stateSlot = -1;
+        }
 
     public:
         CustomDevice(TProvider const& provider)
             : m_provider(provider)
         {
+            // These never change for a given provider, so they're only retrieved once
+            m_descriptor.Kind = D::s_kind;
+            m_descriptor.VendorId = provider.HardwareVendorId();
+            m_descriptor.ProductId = provider.HardwareProductId();
+            m_descriptor.HardwareVersion = provider.HardwareVersionInfo();
+            m_descriptor.FirmwareVersion = provider.FirmwareVersionInfo();
+            m_descriptor.Profile = Core::HardwareIdTable::DefaultProfile;
+            DeviceFactory::FindProfile(m_descriptor.VendorId, m_descriptor.ProductId, m_descriptor.Profile);
+
+            RefreshInputMap();
+            m_stateSlot = DeviceFactory::States().AcquireSlot();
+
+            m_bufferAccount = std::make_shared<Core::BufferAccount>(DeviceFactory::DeviceBufferLimit());
+            m_reportQueue = std::make_shared<Core::ReportQueue>(DeviceFactory::Workers(), s_reportQueueSize,
+                [this](Core::ReportQueue& queue) { ProcessQueuedReports(queue); });
+        }
+
+        ~CustomDevice()
+        {
+            m_reportQueue->Detach();
+            DeviceFactory::States().ReleaseSlot(m_stateSlot);
+        }
+
+        // Signalled after every report, and when the device is removed
+        Core::AsyncSignal& ReportSignal() noexcept
+        {
+            return m_reportSignal;
+        }
+
+        // Signalled once the device is ready, or if it's removed before then
+        Core::AsyncSignal& ReadySignal() noexcept
+        {
+            return m_readySignal;
+        }
+
+        uint64_t DroppedReports()
+        {
+            return m_reportQueue->Dropped();
+        }
+
+        WGIC::ReportBufferUsage GetBufferUsage()
+        {
+            return {
+                m_bufferAccount->Used(),
+                m_bufferAccount->Peak(),
+                m_bufferAccount->Limit(),
+                m_bufferAccount->FailedAllocations()
+            };
+        }
+
+        void SetBufferLimit(uint64_t limit)
+        {
+            m_bufferAccount->SetLimit(limit);
+        }
+
+        void SetIdleDetection(uint32_t unchangedCount, uint64_t heartbeatInterval)
+        {
+            std::lock_guard<std::mutex> lock(m_readingLock);
+            m_idleDetector.Configure(unchangedCount, heartbeatInterval);
+        }
+
+        bool IsIdle()
+        {
+            std::lock_guard<std::mutex> lock(m_readingLock);
+            return m_idleDetector.Idle();
+        }
+
+        uint64_t SkippedReports()
+        {
+            std::lock_guard<std::mutex> lock(m_readingLock);
+            return m_idleDetector.Skipped();
+        }
+
+        uint64_t ToHostTime(uint64_t timestamp)
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            return m_clock.ToHost(timestamp);
+        }
+
+        WGIC::ClockAlignment GetClockAlignment()
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            return {
+                m_clock.Fitted(),
+                m_clock.DriftPpm(),
+                m_clock.Jitter(),
+                static_cast<uint32_t>(m_clock.Samples())
+            };
+        }
+
+        int32_t StateSlot()
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            return m_stateSlot;
+        }
+
+        WGIC::DeviceDescriptor GetDescriptor()
+        {
+            return m_descriptor;
+        }
+
+        WGIC::DeviceKind Kind()
+        {
+            return m_descriptor.Kind;
         }
 
         uint16_t VendorId()
         {
-            return m_provider.HardwareVendorId();
+            return m_descriptor.VendorId;
         }
 
         uint16_t ProductId()
         {
-            return m_provider.HardwareProductId();
+            return m_descriptor.ProductId;
         }
 
         Custom::GameControllerVersionInfo HardwareVersion()
         {
-            return m_provider.HardwareVersionInfo();
+            return m_descriptor.HardwareVersion;
         }
 
         Custom::GameControllerVersionInfo FirmwareVersion()
         {
-            return m_provider.FirmwareVersionInfo();
+            return m_descriptor.FirmwareVersion;
         }
 
         bool IsConnected()
@@ -140,6 +507,226 @@ namespace winrt::WGIC
             return m_provider.IsConnected();
         }
 
+        bool IsReady()
+        {
+            return m_lifecycle.Ready();
+        }
+
+        // Gives C++ callers direct access to the history, such as for zero-copy range queries
+        std::shared_ptr<const Core::StateHistory> History() const
+        {
+            return std::atomic_load(&m_history);
+        }
+
+        void EnableHistory(uint64_t retention, uint32_t capacity)
+        {
+            std::shared_ptr<Core::StateHistory> history;
+            if (capacity != 0)
+                history = std::make_shared<Core::StateHistory>(capacity, retention);
+
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            std::atomic_store(&m_history, std::move(history));
+        }
+
+        bool GetStateAt(uint64_t timestamp, uint64_t& entryTimestamp, uint64_t& buttons, winrt::array_view<int32_t> axes,
+            winrt::array_view<uint8_t> hats)
+        {
+            Core::ControlState state {};
+            auto history = History();
+            bool found = history && history->StateAt(timestamp, entryTimestamp, state);
+            if (!found)
+                entryTimestamp = 0;
+
+            buttons = state.Buttons;
+            memcpy(axes.data(), state.Axes, std::min<size_t>(sizeof(state.Axes), axes.size() * sizeof(int32_t)));
+            memcpy(hats.data(), state.Hats, std::min<size_t>(sizeof(state.Hats), hats.size()));
+            return found;
+        }
+
+        uint32_t GetHistoryRange(uint64_t from, uint64_t to, winrt::array_view<uint64_t> timestamps,
+            winrt::array_view<uint64_t> buttons, winrt::array_view<int32_t> axes, winrt::array_view<uint8_t> hats)
+        {
+            auto history = History();
+            if (!history)
+                return 0;
+
+            uint32_t capacity = std::min({
+                timestamps.size(),
+                buttons.size(),
+                static_cast<uint32_t>(axes.size() / Core::AxesPerDevice),
+                static_cast<uint32_t>(hats.size() / Core::HatsPerDevice)
+            });
+
+            auto copy = [&](uint64_t& token)
+            {
+                Core::HistorySpan spans[2];
+                history->Range(from, to, spans, token);
+
+                uint32_t total = 0;
+                for (auto const& span : spans)
+                {
+                    for (size_t i = 0; i < span.Count && total < capacity; i++, total++)
+                    {
+                        timestamps[total] = span.Timestamps[i];
+                        buttons[total] = span.States[i].Buttons;
+                        memcpy(&axes[total * Core::AxesPerDevice], span.States[i].Axes, sizeof(span.States[i].Axes));
+                        memcpy(&hats[total * Core::HatsPerDevice], span.States[i].Hats, sizeof(span.States[i].Hats));
+                    }
+                }
+
+                return total;
+            };
+
+            // Copied straight out of the history, starting over if the worker overwrote the range in the meantime.
+            // A device that keeps overwriting it could starve the caller that way, so after a few tries the copy is
+            // made with m_processingLock held, which keeps the worker from appending until it's done.
+            uint64_t token;
+            for (int attempt = 0; attempt < s_historyReadAttempts; attempt++)
+            {
+                uint32_t total = copy(token);
+                if (total == 0 || history->StillValid(token))
+                    return total;
+            }
+
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            return copy(token);
+        }
+
+        // Gives C++ callers direct access to the archive, such as for decoding reports without copying them out
+        std::shared_ptr<const Core::ReportArchive> Archive() const
+        {
+            return std::atomic_load(&m_archive);
+        }
+
+        void EnableArchive(uint32_t keyframeInterval)
+        {
+            std::shared_ptr<Core::ReportArchive> archive;
+            if (keyframeInterval != 0)
+                archive = Core::ReportArchive::Create(DeviceFactory::ArchiveBudget(), keyframeInterval);
+
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            std::atomic_store(&m_archive, std::move(archive));
+        }
+
+        uint64_t ArchiveSize()
+        {
+            auto archive = Archive();
+            return archive ? archive->Size() : 0;
+        }
+
+        uint32_t ReadArchive(uint64_t from, uint64_t to, winrt::array_view<uint64_t> timestamps,
+            winrt::array_view<uint8_t> reportIds, winrt::array_view<uint32_t> lengths, winrt::array_view<uint8_t> data)
+        {
+            auto archive = Archive();
+            if (!archive)
+                return 0;
+
+            uint32_t capacity = std::min({ timestamps.size(), reportIds.size(), lengths.size() });
+            uint32_t total = 0;
+            uint32_t offset = 0;
+            archive->ForEach(from, to, [&](uint64_t timestamp, uint8_t reportId, const uint8_t* report, size_t length)
+            {
+                if (total == capacity || length > data.size() - offset)
+                    return false;
+
+                timestamps[total] = timestamp;
+                reportIds[total] = reportId;
+                lengths[total] = static_cast<uint32_t>(length);
+                memcpy(data.data() + offset, report, length);
+                offset += static_cast<uint32_t>(length);
+                total++;
+                return true;
+            });
+
+            return total;
+        }
+
+        WGIC::ReportSubscription Subscribe(bool fromNow)
+        {
+            std::shared_ptr<const Core::LocalBroadcastRing> ring;
+            {
+                std::lock_guard<std::mutex> lock(m_processingLock);
+                if (!m_broadcast)
+                    m_broadcast = std::make_shared<Core::LocalBroadcastRing>(s_broadcastSlots, s_broadcastReportSize);
+                ring = m_broadcast;
+            }
+
+            return winrt::make<implementation::ReportSubscription>(std::move(ring), fromNow);
+        }
+
+        uint32_t ReadInputEvents(winrt::array_view<WGIC::InputEvent> events)
+        {
+            Core::InputEvent drained[32];
+            uint32_t total = 0;
+
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            while (total < events.size())
+            {
+                size_t count = m_eventQueue.Drain(drained, std::min<size_t>(std::size(drained), events.size() - total));
+                if (count == 0)
+                    break;
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    events[total++] = {
+                        drained[i].Timestamp,
+                        m_clock.ToHost(drained[i].Timestamp),
+                        static_cast<WGIC::InputEventType>(drained[i].Type),
+                        drained[i].Control,
+                        drained[i].Value
+                    };
+                }
+            }
+
+            return total;
+        }
+
+        void EnableResampling(uint32_t ticksPerSecond, bool interpolateAxes)
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            m_resampler = ticksPerSecond != 0
+                ? Core::TickResampler(ticksPerSecond, interpolateAxes, ticksPerSecond) // Up to a second of ticks
+                : Core::TickResampler();
+        }
+
+        void AdvanceResampling(uint64_t timestamp)
+        {
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            m_resampler.AdvanceTo(timestamp);
+        }
+
+        uint32_t ReadResampledTicks(winrt::array_view<uint64_t> timestamps, winrt::array_view<uint64_t> buttons,
+            winrt::array_view<int32_t> axes, winrt::array_view<uint8_t> hats)
+        {
+            uint32_t capacity = std::min({
+                timestamps.size(),
+                buttons.size(),
+                static_cast<uint32_t>(axes.size() / Core::AxesPerDevice),
+                static_cast<uint32_t>(hats.size() / Core::HatsPerDevice)
+            });
+
+            Core::TickSample drained[16];
+            uint32_t total = 0;
+
+            std::lock_guard<std::mutex> lock(m_processingLock);
+            while (total < capacity)
+            {
+                size_t count = m_resampler.Drain(drained, std::min<size_t>(std::size(drained), capacity - total));
+                if (count == 0)
+                    break;
+
+                for (size_t i = 0; i < count; i++, total++)
+                {
+                    timestamps[total] = drained[i].Timestamp;
+                    buttons[total] = drained[i].State.Buttons;
+                    memcpy(&axes[total * Core::AxesPerDevice], drained[i].State.Axes, sizeof(drained[i].State.Axes));
+                    memcpy(&hats[total * Core::HatsPerDevice], drained[i].State.Hats, sizeof(drained[i].State.Hats));
+                }
+            }
+
+            return total;
+        }
+
         void OnInputSuspended(uint64_t timestamp)
         {
 #ifdef _DEBUG
@@ -1,17 +1,45 @@
 #include "pch.h"
-#include "WGIC/HidDevice.h"
-#include "WGIC/XusbDevice.h"
-#include "WGIC/GipDevice.h"
+#include "WGIC/DeviceTypes.h"
 #include "WGIC/DeviceFactory.h"
 
-namespace WGIC_impl = winrt::WGIC::implementation;
-
 namespace winrt::WGIC
 {
+    namespace
+    {
+        // Runs one device's setup on DeviceFactory::InitWorkers()
+        class DeviceInitTask : public Core::WorkerPool::Task
+        {
+        private:
+            std::function<void()> m_run;
+
+        public:
+            explicit DeviceInitTask(std::function<void()> run)
+                : m_run(std::move(run))
+            {
+            }
+
+            void Run() override
+            {
+                m_run();
+            }
+        };
+    }
+
     Custom::ICustomGameControllerFactory DeviceFactory::s_factory = winrt::make<WGIC::DeviceFactory>();
+    Core::StateTable DeviceFactory::s_states {};
+    Core::HardwareIdTable DeviceFactory::s_hardwareIds {};
+    std::mutex DeviceFactory::s_hardwareIdsLock {};
+    Core::AsyncSignal DeviceFactory::s_devicesChanged {};
+    std::shared_ptr<Core::ArchiveBudget> DeviceFactory::s_archiveBudget = std::make_shared<Core::ArchiveBudget>(64ull << 20);
+    std::atomic<uint64_t> DeviceFactory::s_deviceBufferLimit { 0 };
 
     void DeviceFactory::RegisterHardwareIds(uint16_t vendorId, uint16_t productId)
     {
+        {
+            std::lock_guard<std::mutex> lock(s_hardwareIdsLock);
+            s_hardwareIds.Add({ vendorId, productId, Core::HardwareIdTable::DefaultProfile });
+        }
+
         Custom::GameControllerFactoryManager::RegisterCustomFactoryForHardwareId(s_factory, vendorId, productId);
     }
 
@@ -25,90 +53,127 @@ namespace winrt::WGIC
         Custom::GameControllerFactoryManager::RegisterCustomFactoryForGipInterface(s_factory, interfaceGuid);
     }
 
-    Foundation::IInspectable DeviceFactory::CreateGameController(Custom::IGameControllerProvider const& provider)
+    uint32_t DeviceFactory::RegisterDeviceTable(Core::DeviceTableFile const& file)
     {
-        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::CreateGameController");
-        Utilities::LogIInspectable(logger, provider);
-
-        auto hidProvider = provider.try_as<Custom::HidGameControllerProvider>();
-        if (hidProvider)
         {
-            return winrt::make<WGIC_impl::HidDevice>(hidProvider);
+            std::lock_guard<std::mutex> lock(s_hardwareIdsLock);
+            s_hardwareIds.AddRange(file.HardwareIds.data(), file.HardwareIds.size());
         }
 
-        auto xusbProvider = provider.try_as<Custom::XusbGameControllerProvider>();
-        if (xusbProvider)
+        // The factory manager has no bulk registration, so each ID still needs its own call.
+        // Rejected IDs are only kept in the table, so they can override XUSB type and GIP interface matches.
+        for (auto const& hardwareId : file.HardwareIds)
         {
-            return winrt::make<WGIC_impl::XusbDevice>(xusbProvider);
+            if (hardwareId.Profile != Core::HardwareIdTable::RejectedProfile)
+            {
+                Custom::GameControllerFactoryManager::RegisterCustomFactoryForHardwareId(s_factory,
+                    hardwareId.VendorId, hardwareId.ProductId);
+            }
         }
 
-        auto gipProvider = provider.try_as<Custom::GipGameControllerProvider>();
-        if (gipProvider)
+        for (auto const& interfaceGuid : file.InterfaceGuids)
         {
-            return winrt::make<WGIC_impl::GipDevice>(gipProvider);
+            winrt::guid guid;
+            static_assert(sizeof(guid) == std::tuple_size_v<Core::InterfaceGuid>);
+            memcpy(&guid, interfaceGuid.data(), sizeof(guid));
+            Custom::GameControllerFactoryManager::RegisterCustomFactoryForGipInterface(s_factory, guid);
         }
 
-        logger->error("Invalid provider received!");
-        throw winrt::hresult_invalid_argument();
+        return static_cast<uint32_t>(file.HardwareIds.size() + file.InterfaceGuids.size());
     }
 
-    void DeviceFactory::OnGameControllerAdded(Input::IGameController const& controller)
+    bool DeviceFactory::FindProfile(uint16_t vendorId, uint16_t productId, uint16_t& profile)
     {
-        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerAdded");
-        Utilities::LogIInspectable(logger, controller);
+        std::lock_guard<std::mutex> lock(s_hardwareIdsLock);
+        return s_hardwareIds.Find(vendorId, productId, profile);
+    }
+
+    Foundation::IInspectable DeviceFactory::CreateGameController(Custom::IGameControllerProvider const& provider)
+    {
+        // The provider is logged by ConnectDevice, so as not to hold up the thread creating the device
+        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::CreateGameController");
 
-        auto hidDevice = controller.try_as<WGIC::HidDevice>();
-        if (hidDevice)
+        uint16_t profile = Core::HardwareIdTable::DefaultProfile;
+        if (FindProfile(provider.HardwareVendorId(), provider.HardwareProductId(), profile) &&
+            profile == Core::HardwareIdTable::RejectedProfile)
         {
-            WGIC_impl::HidDevice::AddDevice(hidDevice);
-            return;
+            logger->debug("Rejected device, vendor ID: 0x{:04X}, product ID: 0x{:04X}", provider.HardwareVendorId(), provider.HardwareProductId());
+            return nullptr;
         }
 
-        auto xusbDevice = controller.try_as<WGIC::XusbDevice>();
-        if (xusbDevice)
+        Foundation::IInspectable device { nullptr };
+        SupportedDevices::ForProvider(provider, [&](auto* type, auto const& typedProvider)
         {
-            WGIC_impl::XusbDevice::AddDevice(xusbDevice);
-            return;
-        }
+            using TDevice = std::remove_pointer_t<decltype(type)>;
+            device = winrt::make<TDevice>(typedProvider);
+        });
 
-        auto gipDevice = controller.try_as<WGIC::GipDevice>();
-        if (gipDevice)
+        if (!device)
         {
-            WGIC_impl::GipDevice::AddDevice(gipDevice);
-            return;
+            logger->error("Invalid provider received!");
+            throw winrt::hresult_invalid_argument();
         }
 
-        logger->error("Invalid device received!");
-        throw winrt::hresult_invalid_argument();
+        return device;
     }
 
-    void DeviceFactory::OnGameControllerRemoved(Input::IGameController const& controller)
+    void DeviceFactory::OnGameControllerAdded(Input::IGameController const& controller)
     {
-        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerRemoved");
-        Utilities::LogIInspectable(logger, controller);
+        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerAdded");
 
-        auto hidDevice = controller.try_as<WGIC::HidDevice>();
-        if (hidDevice)
+        // Only the device's type is checked here; the rest of its setup is queued so that this returns straight away
+        auto device = controller.try_as<WGIC::ICustomDevice>();
+        bool handled = device && SupportedDevices::ForKind(device.Kind(), [&](auto* type)
+        {
+            using TDevice = std::remove_pointer_t<decltype(type)>;
+            InitWorkers().Submit(std::make_shared<DeviceInitTask>([device]
+            {
+                try
+                {
+                    TDevice::ConnectDevice(*winrt::get_self<TDevice>(device));
+                }
+                catch (winrt::hresult_error const& error)
+                {
+                    auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerAdded");
+                    logger->error("Failed to set up device: {}", winrt::to_string(error.message()));
+
+                    // Don't leave anything waiting for it to be ready
+                    TDevice::AbandonDevice(*winrt::get_self<TDevice>(device));
+                }
+                catch (...)
+                {
+                    // Nothing else would catch it on an init worker, and the app would terminate
+                    auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerAdded");
+                    logger->error("Failed to set up device: unknown exception!");
+
+                    TDevice::AbandonDevice(*winrt::get_self<TDevice>(device));
+                }
+            }));
+        });
+
+        if (!handled)
         {
-            WGIC_impl::HidDevice::RemoveDevice(hidDevice);
-            return;
+            logger->error("Invalid device received!");
+            throw winrt::hresult_invalid_argument();
         }
+    }
+
+    void DeviceFactory::OnGameControllerRemoved(Input::IGameController const& controller)
+    {
+        auto logger = spdlog::get(s_loggerName)->clone("DeviceFactory::OnGameControllerRemoved");
+        Utilities::LogIInspectable(logger, controller);
 
-        auto xusbDevice = controller.try_as<WGIC::XusbDevice>();
-        if (xusbDevice)
+        auto device = controller.try_as<WGIC::ICustomDevice>();
+        bool handled = device && SupportedDevices::ForKind(device.Kind(), [&](auto* type)
         {
-            WGIC_impl::XusbDevice::RemoveDevice(xusbDevice);
-            return;
-        }
+            using TDevice = std::remove_pointer_t<decltype(type)>;
+            TDevice::DisconnectDevice(*winrt::get_self<TDevice>(device));
+        });
 
-        auto gipDevice = controller.try_as<WGIC::GipDevice>();
-        if (gipDevice)
+        if (!handled)
         {
-            WGIC_impl::GipDevice::RemoveDevice(gipDevice);
-            return;
+            logger->error("Invalid device received!");
+            throw winrt::hresult_invalid_argument();
         }
-
-        logger->error("Invalid device received!");
-        throw winrt::hresult_invalid_argument();
     }
 }
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 #include "pch.h"
+#include "WGIC/AsyncSignal.h"
+#include "WGIC/BufferPool.h"
+#include "WGIC/HardwareIdTable.h"
+#include "WGIC/ReportArchive.h"
+#include "WGIC/StateTable.h"
+#include "WGIC/WorkerPool.h"
 
 namespace winrt::WGIC
 {
@@ -7,11 +13,68 @@ namespace winrt::WGIC
     {
     private:
         static Custom::ICustomGameControllerFactory s_factory;
+        static Core::StateTable s_states;
+        static Core::HardwareIdTable s_hardwareIds;
+        static std::mutex s_hardwareIdsLock;
+        static Core::AsyncSignal s_devicesChanged;
+        static std::shared_ptr<Core::ArchiveBudget> s_archiveBudget;
+        static std::atomic<uint64_t> s_deviceBufferLimit;
 
     public:
+        // State table shared by all devices, regardless of kind
+        static Core::StateTable& States()
+        {
+            return s_states;
+        }
+
+        // Signalled whenever a device of any kind is added or removed
+        static Core::AsyncSignal& DevicesChanged()
+        {
+            return s_devicesChanged;
+        }
+
+        // Threads that process the reports of every device, so the input sinks only have to queue them
+        static Core::WorkerPool& Workers()
+        {
+            static Core::WorkerPool workers(std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u));
+            return workers;
+        }
+
+        // Threads that set up newly-connected devices, kept apart from Workers() since setup can block
+        static Core::WorkerPool& InitWorkers()
+        {
+            static Core::WorkerPool workers(std::clamp(std::thread::hardware_concurrency(), 2u, 4u));
+            return workers;
+        }
+
+        // Size limit shared by the report archives of every device
+        static std::shared_ptr<Core::ArchiveBudget> const& ArchiveBudget()
+        {
+            return s_archiveBudget;
+        }
+
+        // Pool for the report and message buffers of every device
+        static Core::BufferPool& Buffers()
+        {
+            return Core::BufferPool::Global();
+        }
+
+        // Buffer limit for devices created from now on, or 0 for none
+        static uint64_t DeviceBufferLimit()
+        {
+            return s_deviceBufferLimit.load(std::memory_order_relaxed);
+        }
+
+        static void DeviceBufferLimit(uint64_t limit)
+        {
+            s_deviceBufferLimit.store(limit, std::memory_order_relaxed);
+        }
+
         static void RegisterHardwareIds(uint16_t vendorId, uint16_t productId);
         static void RegisterXusbType(Custom::XusbDeviceType type, Custom::XusbDeviceSubtype subtype);
         static void RegisterGipInterfaceGuid(winrt::guid const& interfaceGuid);
+        static uint32_t RegisterDeviceTable(Core::DeviceTableFile const& file);
+        static bool FindProfile(uint16_t vendorId, uint16_t productId, uint16_t& profile);
 
         template<typename TDevice>
         static TDevice FromGameController(Input::IGameController const& gameController)
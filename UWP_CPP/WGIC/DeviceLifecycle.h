@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <mutex>
+
+namespace winrt::WGIC::Core
+{
+    // Orders a device's announcement and removal. Connect runs once the device has been set up, on whichever thread
+    // did that, while Remove runs on whichever thread reported the disconnection, so the two can overlap. Listing
+    // and unlisting the device happen under the lifecycle lock, so a device that was removed is never listed; the
+    // events are raised after releasing it, since their handlers can run anything, including Remove. DeviceRemoved
+    // is never raised before DeviceAdded has returned.
+    class DeviceLifecycle
+    {
+    private:
+        std::mutex m_lock;
+        bool m_removed = false;
+        bool m_announced = false;          // Connect has finished raising DeviceAdded
+        bool m_removedUnannounced = false; // Unlisted before then, so Connect raises DeviceRemoved too
+        std::atomic<bool> m_ready { false };
+
+    public:
+        // True once the device has been listed, and it stays true after removal
+        bool Ready() const noexcept
+        {
+            return m_ready.load(std::memory_order_acquire);
+        }
+
+        // list adds the device to the device list, returning false if it was already there, and added and removed
+        // raise DeviceAdded and DeviceRemoved. Returns false, having done nothing, if the device was removed first.
+        template<typename TList, typename TAdded, typename TRemoved>
+        bool Connect(TList&& list, TAdded&& added, TRemoved&& removed)
+        {
+            bool listed = false;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_removed)
+                    return false;
+
+                listed = list();
+                m_ready.store(true, std::memory_order_release);
+            }
+
+            if (listed)
+                added();
+
+            // A Remove that came in while DeviceAdded was being raised leaves DeviceRemoved to this
+            bool removedMeanwhile = false;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_announced = true;
+                removedMeanwhile = m_removedUnannounced;
+            }
+
+            if (removedMeanwhile)
+                removed();
+            return true;
+        }
+
+        // unlist removes the device from the device list, returning false if it wasn't there. Returns true if the
+        // caller should raise DeviceRemoved, once it holds no locks.
+        template<typename TUnlist>
+        bool Remove(TUnlist&& unlist)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_removed = true;
+            if (!unlist())
+                return false;
+
+            if (!m_announced)
+            {
+                m_removedUnannounced = true;
+                return false;
+            }
+
+            return true;
+        }
+
+        // Gives up on a device whose setup failed. It's treated as removed, so it's never listed if it wasn't
+        // already. If it failed in a DeviceAdded handler, Remove still has DeviceRemoved raised for it later.
+        void Abandon() noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_removed = true;
+            m_announced = true;
+        }
+    };
+}
@@ -0,0 +1,105 @@
+#include "pch.h"
+#include "WGIC/DeviceStates.h"
+#include "WGIC.DeviceStates.g.cpp"
+#include "WGIC/DeviceFactory.h"
+
+namespace winrt::WGIC::implementation
+{
+    std::mutex DeviceStates::s_filterLock;
+    Core::AxisFilterBank DeviceStates::s_filters;
+
+    uint32_t DeviceStates::MaxDevices()
+    {
+        return Core::MaxDeviceSlots;
+    }
+
+    uint32_t DeviceStates::AxesPerDevice()
+    {
+        return Core::AxesPerDevice;
+    }
+
+    uint32_t DeviceStates::HatsPerDevice()
+    {
+        return Core::HatsPerDevice;
+    }
+
+    uint64_t DeviceStates::SnapshotAll(uint32_t& activeSlots, winrt::array_view<uint64_t> timestamps,
+        winrt::array_view<uint64_t> buttons, winrt::array_view<int32_t> axes, winrt::array_view<uint8_t> hats)
+    {
+        if (timestamps.size() < Core::MaxDeviceSlots ||
+            buttons.size() < Core::MaxDeviceSlots ||
+            axes.size() < Core::MaxDeviceSlots * Core::AxesPerDevice ||
+            hats.size() < Core::MaxDeviceSlots * Core::HatsPerDevice)
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("DeviceStates::SnapshotAll");
+            logger->error("Buffers are too small!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        // Taken in a single copy so the table lock is held as briefly as possible
+        Core::StateSnapshot snapshot;
+        DeviceFactory::States().Snapshot(snapshot);
+
+        activeSlots = snapshot.ActiveSlots;
+        memcpy(timestamps.data(), snapshot.Timestamps, sizeof(snapshot.Timestamps));
+        memcpy(buttons.data(), snapshot.Buttons, sizeof(snapshot.Buttons));
+        memcpy(axes.data(), snapshot.Axes, sizeof(snapshot.Axes));
+        memcpy(hats.data(), snapshot.Hats, sizeof(snapshot.Hats));
+        return snapshot.Generation;
+    }
+
+    void DeviceStates::ConfigureAxisFilter(uint32_t slot, uint32_t axis, WGIC::AxisFilterSettings const& settings)
+    {
+        if (slot >= Core::MaxDeviceSlots || axis >= Core::AxesPerDevice)
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("DeviceStates::ConfigureAxisFilter");
+            logger->error("Slot {} axis {} is out of range!", slot, axis);
+            throw winrt::hresult_invalid_argument();
+        }
+
+        Core::AxisFilterSettings filter;
+        filter.Center = settings.Center;
+        filter.Scale = settings.Scale;
+        filter.InnerDeadzone = settings.InnerDeadzone;
+        filter.OuterDeadzone = settings.OuterDeadzone;
+        filter.RadialDeadzone = settings.RadialDeadzone;
+        filter.CurveCubic = settings.CurveCubic;
+        filter.Smoothing = static_cast<Core::AxisSmoothing>(settings.Smoothing);
+        filter.SmoothingFactor = settings.SmoothingFactor;
+        filter.MinCutoff = settings.MinCutoff;
+        filter.Beta = settings.Beta;
+        filter.DerivativeCutoff = settings.DerivativeCutoff;
+
+        std::lock_guard<std::mutex> lock(s_filterLock);
+        s_filters.Configure(slot, axis, filter);
+    }
+
+    void DeviceStates::ResetAxisFilters(uint32_t slot)
+    {
+        std::lock_guard<std::mutex> lock(s_filterLock);
+        s_filters.Reset(slot);
+    }
+
+    uint64_t DeviceStates::UpdateFilteredAxes(double deltaSeconds, winrt::array_view<float> axes)
+    {
+        if (axes.size() < Core::MaxDeviceSlots * Core::AxesPerDevice)
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("DeviceStates::UpdateFilteredAxes");
+            logger->error("Buffer is too small!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        Core::StateSnapshot snapshot;
+        DeviceFactory::States().Snapshot(snapshot);
+
+        // All slots are filtered together in one pass
+        float filtered[Core::MaxDeviceSlots][Core::AxesPerDevice];
+        {
+            std::lock_guard<std::mutex> lock(s_filterLock);
+            s_filters.Process(snapshot, filtered, static_cast<float>(deltaSeconds));
+        }
+
+        memcpy(axes.data(), filtered, sizeof(filtered));
+        return snapshot.Generation;
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.DeviceStates.g.h"
+#include "WGIC/AxisFilterBank.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct DeviceStates
+    {
+    public:
+        static uint32_t MaxDevices();
+        static uint32_t AxesPerDevice();
+        static uint32_t HatsPerDevice();
+
+        static uint64_t SnapshotAll(uint32_t& activeSlots, winrt::array_view<uint64_t> timestamps,
+            winrt::array_view<uint64_t> buttons, winrt::array_view<int32_t> axes, winrt::array_view<uint8_t> hats);
+
+        static void ConfigureAxisFilter(uint32_t slot, uint32_t axis, WGIC::AxisFilterSettings const& settings);
+        static void ResetAxisFilters(uint32_t slot);
+        static uint64_t UpdateFilteredAxes(double deltaSeconds, winrt::array_view<float> axes);
+
+    private:
+        static std::mutex s_filterLock;
+        static Core::AxisFilterBank s_filters;
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct DeviceStates : DeviceStatesT<DeviceStates, implementation::DeviceStates>
+    {
+    };
+}
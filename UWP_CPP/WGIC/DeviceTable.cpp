@@ -0,0 +1,36 @@
+#include "pch.h"
+#include "WGIC/DeviceTable.h"
+#include "WGIC.DeviceTable.g.cpp"
+#include "WGIC/DeviceFactory.h"
+
+namespace winrt::WGIC::implementation
+{
+    uint16_t DeviceTable::DefaultProfile()
+    {
+        return Core::HardwareIdTable::DefaultProfile;
+    }
+
+    uint16_t DeviceTable::RejectedProfile()
+    {
+        return Core::HardwareIdTable::RejectedProfile;
+    }
+
+    uint32_t DeviceTable::Register(winrt::array_view<uint8_t const> table)
+    {
+        Core::DeviceTableFile file;
+        if (!file.Parse(table.data(), table.size()))
+        {
+            auto logger = spdlog::get(s_loggerName)->clone("DeviceTable::Register");
+            logger->error("Invalid device table!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        return DeviceFactory::RegisterDeviceTable(file);
+    }
+
+    bool DeviceTable::TryGetProfile(uint16_t vendorId, uint16_t productId, uint16_t& profile)
+    {
+        profile = Core::HardwareIdTable::DefaultProfile;
+        return DeviceFactory::FindProfile(vendorId, productId, profile);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.DeviceTable.g.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct DeviceTable
+    {
+    public:
+        static uint16_t DefaultProfile();
+        static uint16_t RejectedProfile();
+
+        static uint32_t Register(winrt::array_view<uint8_t const> table);
+        static bool TryGetProfile(uint16_t vendorId, uint16_t productId, uint16_t& profile);
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct DeviceTable : DeviceTableT<DeviceTable, implementation::DeviceTable>
+    {
+    };
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include "pch.h"
+#include "WGIC/HidDevice.h"
+#include "WGIC/XusbDevice.h"
+#include "WGIC/GipDevice.h"
+
+namespace winrt::WGIC
+{
+    // Compile-time list of device implementations, used to generate the dispatch code for each supported kind
+    template<typename... TDevices>
+    struct DeviceTypeList
+    {
+        // Calls func with a null pointer of the implementation type matching the given provider.
+        // Returns false if none of the types accept the provider.
+        template<typename TFunc>
+        static bool ForProvider(Custom::IGameControllerProvider const& provider, TFunc&& func)
+        {
+            return (TryProvider<TDevices>(provider, func) || ...);
+        }
+
+        // Calls func with a null pointer of the implementation type for the given kind.
+        // Returns false if the kind is not in the list.
+        template<typename TFunc>
+        static bool ForKind(WGIC::DeviceKind kind, TFunc&& func)
+        {
+            return (TryKind<TDevices>(kind, func) || ...);
+        }
+
+        // Calls func with a null pointer of each implementation type in the list
+        template<typename TFunc>
+        static void ForEach(TFunc&& func)
+        {
+            (func(static_cast<TDevices*>(nullptr)), ...);
+        }
+
+    private:
+        template<typename TDevice, typename TFunc>
+        static bool TryProvider(Custom::IGameControllerProvider const& provider, TFunc& func)
+        {
+            auto typedProvider = provider.try_as<typename TDevice::provider_type>();
+            if (!typedProvider)
+                return false;
+
+            func(static_cast<TDevice*>(nullptr), typedProvider);
+            return true;
+        }
+
+        template<typename TDevice, typename TFunc>
+        static bool TryKind(WGIC::DeviceKind kind, TFunc& func)
+        {
+            if (kind != TDevice::s_kind)
+                return false;
+
+            func(static_cast<TDevice*>(nullptr));
+            return true;
+        }
+    };
+
+    // To add a new kind of device, add its implementation type here
+    using SupportedDevices = DeviceTypeList<
+        implementation::HidDevice,
+        implementation::XusbDevice,
+        implementation::GipDevice
+    >;
+}
@@ -0,0 +1,78 @@
+#include "pch.h"
+#include "WGIC/FlightRecorder.h"
+#include "WGIC.FlightRecorder.g.cpp"
+
+namespace
+{
+    // Where the recording at path is kept when a new one starts: FlightRecording.wgfr becomes FlightRecording.prev.wgfr
+    std::wstring PreviousPath(std::wstring_view path)
+    {
+        size_t name = path.find_last_of(L"\\/");
+        size_t extension = path.rfind(L'.');
+        if (extension == std::wstring_view::npos || (name != std::wstring_view::npos && extension < name))
+            extension = path.size();
+
+        std::wstring previous(path.substr(0, extension));
+        previous += L".prev";
+        previous += path.substr(extension);
+        return previous;
+    }
+}
+
+namespace winrt::WGIC::implementation
+{
+    std::mutex FlightRecorder::s_lock;
+    std::atomic<bool> FlightRecorder::s_running { false };
+    Core::FlightRecording FlightRecorder::s_recording;
+
+    void FlightRecorder::Start(winrt::hstring const& path, uint32_t slotCount, uint32_t maxReportSize)
+    {
+        auto logger = spdlog::get(s_loggerName)->clone("FlightRecorder::Start");
+
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (s_recording.IsOpen())
+        {
+            logger->error("Already running!");
+            throw winrt::hresult_illegal_method_call();
+        }
+
+        if (path.empty() || slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || maxReportSize > UINT16_MAX)
+        {
+            logger->error("Invalid recording parameters!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        // The last recording is the one leading up to a crash, if there was one, so it's kept rather than replaced.
+        // Failing to keep it isn't worth not recording over.
+        std::wstring previous = PreviousPath(path);
+        if (!MoveFileExW(path.c_str(), previous.c_str(), MOVEFILE_REPLACE_EXISTING) && GetLastError() != ERROR_FILE_NOT_FOUND)
+            logger->error("Failed to keep the previous recording as {}!", winrt::to_string(previous));
+
+        if (!s_recording.Create(winrt::to_string(path), slotCount, maxReportSize))
+        {
+            logger->error("Failed to create {}!", winrt::to_string(path));
+            throw winrt::hresult_error(E_FAIL);
+        }
+
+        s_running.store(true, std::memory_order_relaxed);
+        logger->debug("Recording reports to {}", winrt::to_string(path));
+    }
+
+    void FlightRecorder::Stop()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_running.store(false, std::memory_order_relaxed);
+        s_recording.Close();
+    }
+
+    bool FlightRecorder::IsRunning()
+    {
+        return s_running.load(std::memory_order_relaxed);
+    }
+
+    uint64_t FlightRecorder::Recorded()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        return s_recording.IsOpen() ? s_recording.Ring().WriteSequence() : 0;
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.FlightRecorder.g.h"
+#include "WGIC/FlightRecording.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct FlightRecorder
+    {
+    private:
+        static std::mutex s_lock;
+        static std::atomic<bool> s_running;
+        static Core::FlightRecording s_recording;
+
+    public:
+        static void Start(winrt::hstring const& path, uint32_t slotCount, uint32_t maxReportSize);
+        static void Stop();
+
+        static bool IsRunning();
+        static uint64_t Recorded();
+
+        // Called for every report, from whichever worker is processing it
+        static void Publish(Core::ReportRecord const& record, winrt::array_view<uint8_t const> data)
+        {
+            if (!s_running.load(std::memory_order_relaxed))
+                return;
+
+            std::lock_guard<std::mutex> lock(s_lock);
+            if (s_recording.IsOpen())
+                s_recording.Ring().Publish(record, data.data(), data.size());
+        }
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct FlightRecorder : FlightRecorderT<FlightRecorder, implementation::FlightRecorder>
+    {
+    };
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "WGIC/BroadcastRing.h"
+#include "WGIC/MappedFile.h"
+
+namespace winrt::WGIC::Core
+{
+    // A file holding the most recent reports received, as a broadcast ring preceded by a small header.
+    // The recorder publishes straight into the mapped file, so the file is complete up to the last report even if
+    // the process dies; a report that was being written at the time is left torn, which the ring detects.
+    class FlightRecording
+    {
+    public:
+        static constexpr uint32_t Magic = 0x52464757; // "WGFR"
+        static constexpr uint32_t Version = 1;
+
+        struct alignas(64) FileHeader
+        {
+            uint32_t Magic;
+            uint32_t Version;
+            uint64_t StartTime; // Microseconds since the Unix epoch, from the system clock
+        };
+
+    private:
+        MappedFile m_file;
+        BroadcastRing m_ring;
+
+    public:
+        // Creates or replaces a recording with room for slotCount reports (a power of 2)
+        bool Create(std::string const& path, uint32_t slotCount, uint32_t maxReportSize)
+        {
+            if (slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || maxReportSize > UINT16_MAX ||
+                !m_file.Create(path, sizeof(FileHeader) + BroadcastRing::RequiredSize(slotCount, maxReportSize)))
+            {
+                return false;
+            }
+
+            auto header = static_cast<FileHeader*>(m_file.Data());
+            header->Magic = Magic;
+            header->Version = Version;
+            header->StartTime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+
+            if (!m_ring.Initialize(header + 1, m_file.Size() - sizeof(FileHeader), slotCount, maxReportSize))
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+
+        // Opens an existing recording read-only, including one left behind by a crashed process
+        bool Open(std::string const& path)
+        {
+            if (!m_file.Open(path) || m_file.Size() < sizeof(FileHeader))
+            {
+                Close();
+                return false;
+            }
+
+            auto header = static_cast<const FileHeader*>(m_file.Data());
+            if (header->Magic != Magic || header->Version != Version ||
+                !m_ring.Attach(const_cast<FileHeader*>(header + 1), m_file.Size() - sizeof(FileHeader)))
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void Close() noexcept
+        {
+            m_ring = BroadcastRing();
+            m_file.Close();
+        }
+
+        bool IsOpen() const noexcept { return m_ring.IsValid(); }
+
+        FileHeader const& Header() const noexcept { return *static_cast<const FileHeader*>(m_file.Data()); }
+
+        BroadcastRing& Ring() noexcept { return m_ring; }
+        BroadcastRing const& Ring() const noexcept { return m_ring; }
+    };
+}
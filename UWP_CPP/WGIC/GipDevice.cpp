@@ -33,12 +33,46 @@ namespace winrt::WGIC::implementation
         }
     }
 
+    uint32_t GipDevice::CopyLatestMessage(uint64_t& timestamp, Custom::GipMessageClass& messageClass, uint8_t& messageId,
+        uint8_t& sequenceId, winrt::array_view<uint8_t> messageBuffer, WGIC::ReportChange& change)
+    {
+        std::lock_guard<std::mutex> lock(m_readingLock);
+        if (m_inputSuspended)
+        {
+            timestamp = 0;
+            messageClass = static_cast<Custom::GipMessageClass>(0);
+            messageId = 0;
+            sequenceId = 0;
+            change = {};
+            return 0;
+        }
+
+        timestamp = m_currentTimestamp;
+        messageClass = m_currentMessageClass;
+        messageId = m_currentMessageId;
+        sequenceId = m_currentMessageSequence;
+        change = m_currentChange;
+        uint32_t size = m_currentMessage.size();
+        memcpy(messageBuffer.data(), m_currentMessage.data(), std::min(size, messageBuffer.size()));
+        return size;
+    }
+
     void GipDevice::SendMessage(Custom::GipMessageClass const& messageClass, uint8_t messageId,
         winrt::array_view<uint8_t const> messageBuffer)
     {
         m_provider.SendMessage(messageClass, messageId, messageBuffer);
     }
 
+    // Must be called with the reading lock held, before the current message is replaced
+    WGIC::ReportChange GipDevice::CompareMessage(Custom::GipMessageClass messageClass, uint8_t messageId,
+        winrt::array_view<uint8_t const> messageBuffer)
+    {
+        // Messages of different types can't be meaningfully compared
+        uint64_t changeMask = messageClass != m_currentMessageClass || messageId != m_currentMessageId ? ~0ull
+            : Core::ReportChangeMask(m_currentMessage.data(), m_currentMessage.size(), messageBuffer.data(), messageBuffer.size());
+        return { changeMask, changeMask == 0 };
+    }
+
     void GipDevice::OnKeyReceived(uint64_t timestamp, uint8_t keyCode, bool isPressed)
     {
 #ifdef _DEBUG
@@ -50,14 +84,23 @@ namespace winrt::WGIC::implementation
         );
 #endif
 
+        uint8_t keyMessage[2] = { static_cast<uint8_t>(isPressed ? 0x01 : 0x00), keyCode };
+
         std::lock_guard<std::mutex> lock(m_readingLock);
+        WGIC::ReportChange change = CompareMessage(Custom::GipMessageClass::Command, 0x07, keyMessage);
+
+        // The message is dropped if there's no buffer for it
+        if (!ResizeBuffer(m_currentMessage, 2))
+            return;
+
+        m_currentChange = change;
+        QueueReport(timestamp, 0x07, keyMessage, m_currentChange.ChangedBytes,
+            static_cast<uint8_t>(Custom::GipMessageClass::Command));
         m_currentTimestamp = timestamp;
         m_currentMessageClass = Custom::GipMessageClass::Command;
         m_currentMessageId = 0x07;
         m_currentMessageSequence = 0;
-        m_currentMessage = winrt::com_array<uint8_t>(2);
-        m_currentMessage[0] = isPressed ? 0x01 : 0x00;
-        m_currentMessage[1] = keyCode;
+        memcpy(m_currentMessage.data(), keyMessage, 2);
     }
 
     void GipDevice::OnMessageReceived(uint64_t timestamp, Custom::GipMessageClass const& messageClass,
@@ -83,12 +126,19 @@ namespace winrt::WGIC::implementation
 #endif
 
         std::lock_guard<std::mutex> lock(m_readingLock);
+        WGIC::ReportChange change = CompareMessage(messageClass, messageId, messageBuffer);
+
+        // The message is dropped if there's no buffer for it
+        uint32_t size = messageBuffer.size();
+        if (!ResizeBuffer(m_currentMessage, size))
+            return;
+
+        m_currentChange = change;
+        QueueReport(timestamp, messageId, messageBuffer, m_currentChange.ChangedBytes, static_cast<uint8_t>(messageClass));
         m_currentTimestamp = timestamp;
         m_currentMessageClass = messageClass;
         m_currentMessageId = messageId;
         m_currentMessageSequence = sequenceId;
-        int size = messageBuffer.size();
-        m_currentMessage = winrt::com_array<uint8_t>(size);
         memcpy(m_currentMessage.data(), messageBuffer.data(), size);
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "WGIC.GipDevice.g.h"
 #include "WGIC/CustomDevice.h"
+#include "WGIC/ReportDiff.h"
 
 namespace winrt::WGIC::implementation
 {
@@ -9,6 +10,8 @@ namespace winrt::WGIC::implementation
         Custom::IGipGameControllerInputSink>
     {
     public:
+        static constexpr WGIC::DeviceKind s_kind = WGIC::DeviceKind::Gip;
+
         static void RegisterInterfaceGuid(winrt::guid interfaceGuid);
 
     private:
@@ -16,7 +19,11 @@ namespace winrt::WGIC::implementation
         Custom::GipMessageClass m_currentMessageClass = (Custom::GipMessageClass)0;
         uint8_t m_currentMessageId = 0;
         uint8_t m_currentMessageSequence = 0;
-        winrt::com_array<uint8_t> m_currentMessage;
+        Core::PooledBuffer m_currentMessage;
+        WGIC::ReportChange m_currentChange {};
+
+        WGIC::ReportChange CompareMessage(Custom::GipMessageClass messageClass, uint8_t messageId,
+            winrt::array_view<uint8_t const> messageBuffer);
 
     public:
         GipDevice(Custom::GipGameControllerProvider const& provider)
@@ -26,6 +33,9 @@ namespace winrt::WGIC::implementation
 
         void GetLatestMessage(uint64_t& timestamp, Custom::GipMessageClass& messageClass, uint8_t& messageId,
             uint8_t& sequenceId, winrt::com_array<uint8_t>& messageBuffer);
+        uint32_t CopyLatestMessage(uint64_t& timestamp, Custom::GipMessageClass& messageClass, uint8_t& messageId,
+            uint8_t& sequenceId, winrt::array_view<uint8_t> messageBuffer,
+            WGIC::ReportChange& change);
         void SendMessage(Custom::GipMessageClass const& messageClass, uint8_t messageId,
             winrt::array_view<uint8_t const> messageBuffer);
 
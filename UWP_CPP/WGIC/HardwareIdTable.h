@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    struct HardwareIdEntry
+    {
+        uint16_t VendorId;
+        uint16_t ProductId;
+        uint16_t Profile;
+    };
+
+    using InterfaceGuid = std::array<uint8_t, 16>;
+
+    // Contents of a device table file. All values are little-endian:
+    //   char[4]  magic "WGDT"
+    //   uint16   version (1)
+    //   uint16   reserved
+    //   uint32   hardware ID count
+    //   uint32   interface GUID count
+    //   { uint16 vendorId, uint16 productId, uint16 profile } per hardware ID
+    //   { uint32, uint16, uint16, uint8[8] } per interface GUID, laid out the same as a GUID in memory
+    struct DeviceTableFile
+    {
+        std::vector<HardwareIdEntry> HardwareIds;
+        std::vector<InterfaceGuid> InterfaceGuids;
+
+        static constexpr uint8_t Magic[4] = { 'W', 'G', 'D', 'T' };
+        static constexpr uint16_t Version = 1;
+        static constexpr size_t HeaderSize = 16;
+        static constexpr size_t HardwareIdSize = 6;
+        static constexpr size_t InterfaceGuidSize = 16;
+
+        // Returns false if the data is truncated or isn't a device table
+        bool Parse(const uint8_t* data, size_t length)
+        {
+            HardwareIds.clear();
+            InterfaceGuids.clear();
+
+            if (length < HeaderSize || memcmp(data, Magic, sizeof(Magic)) != 0 || ReadUInt16(data + 4) != Version)
+                return false;
+
+            uint64_t hardwareIdCount = ReadUInt32(data + 8);
+            uint64_t interfaceGuidCount = ReadUInt32(data + 12);
+            if (length < HeaderSize + hardwareIdCount * HardwareIdSize + interfaceGuidCount * InterfaceGuidSize)
+                return false;
+
+            const uint8_t* entry = data + HeaderSize;
+            HardwareIds.resize(static_cast<size_t>(hardwareIdCount));
+            for (auto& hardwareId : HardwareIds)
+            {
+                hardwareId = { ReadUInt16(entry), ReadUInt16(entry + 2), ReadUInt16(entry + 4) };
+                entry += HardwareIdSize;
+            }
+
+            InterfaceGuids.resize(static_cast<size_t>(interfaceGuidCount));
+            for (auto& interfaceGuid : InterfaceGuids)
+            {
+                memcpy(interfaceGuid.data(), entry, InterfaceGuidSize);
+                entry += InterfaceGuidSize;
+            }
+
+            return true;
+        }
+
+    private:
+        static uint16_t ReadUInt16(const uint8_t* data) noexcept
+        {
+            return static_cast<uint16_t>(data[0] | (data[1] << 8));
+        }
+
+        static uint32_t ReadUInt32(const uint8_t* data) noexcept
+        {
+            return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+        }
+    };
+
+    // Sorted lookup from vendor/product ID to a decoder profile.
+    // Entries are kept as a flat array of packed keys so a lookup is a binary search over contiguous memory.
+    class HardwareIdTable
+    {
+    public:
+        static constexpr uint16_t DefaultProfile = 0;
+        // Devices with this profile are left to the system rather than being handled as custom devices
+        static constexpr uint16_t RejectedProfile = 0xFFFF;
+
+    private:
+        // (vendorId << 32) | (productId << 16) | profile, sorted
+        std::vector<uint64_t> m_entries;
+
+    public:
+        size_t Size() const noexcept { return m_entries.size(); }
+
+        // Adds or replaces a single entry
+        void Add(HardwareIdEntry const& entry)
+        {
+            uint64_t packed = Pack(entry);
+            auto position = std::lower_bound(m_entries.begin(), m_entries.end(), packed & ~0xFFFFull);
+            if (position != m_entries.end() && (*position >> 16) == (packed >> 16))
+                *position = packed;
+            else
+                m_entries.insert(position, packed);
+        }
+
+        // Adds or replaces many entries with a single sort, rather than an insertion per entry.
+        // Later entries take precedence over earlier ones and over existing entries.
+        void AddRange(const HardwareIdEntry* entries, size_t count)
+        {
+            std::vector<uint64_t> added(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                added[i] = Pack(entries[i]);
+            }
+
+            // Stable so duplicates keep their order, and only the last of each ID is kept
+            std::stable_sort(added.begin(), added.end(), [](uint64_t a, uint64_t b) { return (a >> 16) < (b >> 16); });
+
+            std::vector<uint64_t> merged;
+            merged.reserve(m_entries.size() + added.size());
+            auto existing = m_entries.begin();
+            for (size_t i = 0; i < added.size(); i++)
+            {
+                uint64_t entry = added[i];
+                if (i + 1 < added.size() && (added[i + 1] >> 16) == (entry >> 16))
+                    continue;
+
+                for (; existing != m_entries.end() && (*existing >> 16) < (entry >> 16); ++existing)
+                    merged.push_back(*existing);
+                if (existing != m_entries.end() && (*existing >> 16) == (entry >> 16))
+                    ++existing;
+                merged.push_back(entry);
+            }
+            merged.insert(merged.end(), existing, m_entries.end());
+            m_entries = std::move(merged);
+        }
+
+        bool Find(uint16_t vendorId, uint16_t productId, uint16_t& profile) const noexcept
+        {
+            uint64_t key = Pack({ vendorId, productId, 0 });
+            auto position = std::lower_bound(m_entries.begin(), m_entries.end(), key);
+            if (position == m_entries.end() || (*position >> 16) != (key >> 16))
+                return false;
+
+            profile = static_cast<uint16_t>(*position);
+            return true;
+        }
+
+    private:
+        static uint64_t Pack(HardwareIdEntry const& entry) noexcept
+        {
+            return (static_cast<uint64_t>(entry.VendorId) << 32) | (static_cast<uint64_t>(entry.ProductId) << 16) | entry.Profile;
+        }
+    };
+}
@@ -2,6 +2,7 @@
 #include "pch.h"
 #include "WGIC.HidDevice.g.h"
 #include "WGIC/CustomDevice.h"
+#include "WGIC/ReportDiff.h"
 
 namespace winrt::WGIC::implementation
 {
@@ -9,12 +10,15 @@ namespace winrt::WGIC::implementation
         Custom::IHidGameControllerInputSink>
     {
     public:
+        static constexpr WGIC::DeviceKind s_kind = WGIC::DeviceKind::Hid;
+
         static void RegisterHardwareIds(uint16_t vendorId, uint16_t productId);
 
     private:
         uint64_t m_currentTimestamp = 0;
         uint8_t m_currentReportId = 0;
-        winrt::com_array<uint8_t> m_currentReport;
+        Core::PooledBuffer m_currentReport;
+        WGIC::ReportChange m_currentChange {};
 
     public:
         HidDevice(Custom::HidGameControllerProvider const& provider)
@@ -23,6 +27,8 @@ namespace winrt::WGIC::implementation
         }
 
         void GetLatestReport(uint64_t& timestamp, uint8_t& reportId, winrt::com_array<uint8_t>& reportBuffer);
+        uint32_t CopyLatestReport(uint64_t& timestamp, uint8_t& reportId, winrt::array_view<uint8_t> reportBuffer,
+            WGIC::ReportChange& change);
         void SendOutputReport(uint8_t& reportId, winrt::array_view<uint8_t const> reportBuffer);
         void SendFeatureReport(uint8_t& reportId, winrt::array_view<uint8_t const> reportBuffer);
 
@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+
+namespace winrt::WGIC::Core
+{
+    // Decides which of a device's reports need processing, from whether their content changed. A device that sends
+    // the same report unchangedCount times in a row is idle, and from then on only one unchanged report per
+    // heartbeatInterval (in report timestamp microseconds) is let through, so that timestamps downstream keep moving.
+    // The first report with any changed byte ends idling and is always let through. An unchangedCount of 0 lets
+    // every report through.
+    class IdleDetector
+    {
+    private:
+        uint32_t m_unchangedCount;
+        uint64_t m_heartbeatInterval;
+
+        uint32_t m_unchanged = 0;
+        bool m_idle = false;
+        uint64_t m_lastPassed = 0;
+        uint64_t m_skipped = 0;
+        uint64_t m_idlePeriods = 0;
+
+    public:
+        IdleDetector(uint32_t unchangedCount = 16, uint64_t heartbeatInterval = 100000) noexcept
+            : m_unchangedCount(unchangedCount), m_heartbeatInterval(heartbeatInterval)
+        {
+        }
+
+        // Changes the settings, keeping the counters. The device is treated as active until it's idle again.
+        void Configure(uint32_t unchangedCount, uint64_t heartbeatInterval) noexcept
+        {
+            m_unchangedCount = unchangedCount;
+            m_heartbeatInterval = heartbeatInterval;
+            m_unchanged = 0;
+            m_idle = false;
+        }
+
+        // changeMask is the result of ReportChangeMask against the previous report.
+        // Returns true if the report should be processed.
+        bool Filter(uint64_t timestamp, uint64_t changeMask) noexcept
+        {
+            if (changeMask != 0 || m_unchangedCount == 0)
+            {
+                m_unchanged = 0;
+                m_idle = false;
+                return Pass(timestamp);
+            }
+
+            if (!m_idle)
+            {
+                if (++m_unchanged < m_unchangedCount)
+                    return Pass(timestamp);
+
+                m_idle = true;
+                m_idlePeriods++;
+            }
+
+            // Timestamps going backwards mean the device's time base was reset
+            if (timestamp - m_lastPassed >= m_heartbeatInterval || timestamp < m_lastPassed)
+                return Pass(timestamp);
+
+            m_skipped++;
+            return false;
+        }
+
+        bool Idle() const noexcept { return m_idle; }
+
+        // Unchanged reports that weren't let through
+        uint64_t Skipped() const noexcept { return m_skipped; }
+
+        // Number of times the device has gone idle
+        uint64_t IdlePeriods() const noexcept { return m_idlePeriods; }
+
+    private:
+        bool Pass(uint64_t timestamp) noexcept
+        {
+            m_lastPassed = timestamp;
+            return true;
+        }
+    };
+}
@@ -0,0 +1,375 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Platform-neutral pieces of WGIC live in the Core namespace, so they can be used and tested outside of WinRT
+namespace winrt::WGIC::Core
+{
+    enum class ControlType : uint8_t
+    {
+        Button,
+        Axis,
+        Hat,
+    };
+
+    enum class ControlTransform : uint8_t
+    {
+        None,
+        Invert,    // Active-low buttons are flipped, axes are mirrored across their range
+        Threshold, // The source is read as an axis, and is pressed while at or above the threshold
+    };
+
+    // Describes where a control is located within a report
+    struct ControlMapping
+    {
+        ControlType Type;
+        uint8_t ReportId;  // Report ID or GIP message ID that the control is located in
+        uint16_t Offset;   // Byte offset of the control
+        uint8_t Bit;       // Bit index for buttons, lowest bit for hats, counted from the start of Offset; may be past the first byte
+        uint8_t Size;      // Size in bytes for axes (1, 2, or 4), size in bits for hats
+        bool Signed;       // Whether an axis value is signed
+        int32_t Threshold; // Value at or above which an axis is considered crossed
+        uint8_t Control;   // Index reported in events for this control
+        ControlTransform Transform;
+    };
+
+    enum class EventType : uint8_t
+    {
+        ButtonPressed,
+        ButtonReleased,
+        AxisAboveThreshold,
+        AxisBelowThreshold,
+        HatChanged,
+    };
+
+    struct InputEvent
+    {
+        uint64_t Timestamp;
+        EventType Type;
+        uint8_t Control;
+        int32_t Value;
+    };
+
+    // Bounded FIFO of input events; the oldest events are dropped once it fills up
+    class EventQueue
+    {
+    private:
+        std::vector<InputEvent> m_events;
+        size_t m_head = 0;
+        size_t m_count = 0;
+        uint64_t m_dropped = 0;
+
+    public:
+        explicit EventQueue(size_t capacity)
+            : m_events(capacity > 0 ? capacity : 1)
+        {
+        }
+
+        size_t Size() const noexcept { return m_count; }
+        uint64_t Dropped() const noexcept { return m_dropped; }
+
+        void Push(InputEvent const& event) noexcept
+        {
+            if (m_count < m_events.size())
+            {
+                m_events[(m_head + m_count) % m_events.size()] = event;
+                m_count++;
+            }
+            else
+            {
+                m_events[m_head] = event;
+                m_head = (m_head + 1) % m_events.size();
+                m_dropped++;
+            }
+        }
+
+        // Removes up to maxCount events from the front of the queue, returning how many were written to output
+        size_t Drain(InputEvent* output, size_t maxCount) noexcept
+        {
+            size_t count = m_count < maxCount ? m_count : maxCount;
+            for (size_t i = 0; i < count; i++)
+            {
+                output[i] = m_events[m_head];
+                m_head = (m_head + 1) % m_events.size();
+            }
+
+            m_count -= count;
+            return count;
+        }
+    };
+
+    using MappingList = std::vector<ControlMapping>;
+
+    // A set of control mappings compiled into a flat table, ordered by report ID and then offset,
+    // with the range of entries for each report ID precomputed so a report only visits its own controls.
+    // Compiled maps are immutable, so a device can switch to a new map between two reports without locking.
+    class InputMap
+    {
+    private:
+        MappingList m_entries;
+        uint32_t m_reportStart[257] {};
+
+    public:
+        explicit InputMap(MappingList mappings)
+            : m_entries(std::move(mappings))
+        {
+            // Bits past the first byte are moved into the offset, so that controls are read from, and checked for
+            // changes at, the bytes they're actually in
+            for (ControlMapping& mapping : m_entries)
+            {
+                if (UsesBit(mapping))
+                {
+                    mapping.Offset = static_cast<uint16_t>(std::min<uint32_t>(mapping.Offset + mapping.Bit / 8u, UINT16_MAX));
+                    mapping.Bit %= 8;
+                }
+            }
+
+            // Mappings which could never be read are dropped here rather than checked on every report
+            m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [](ControlMapping const& mapping)
+                {
+                    size_t byteCount = ByteCount(mapping);
+                    return byteCount < 1 || byteCount > 4 || mapping.Offset == UINT16_MAX;
+                }), m_entries.end());
+
+            std::stable_sort(m_entries.begin(), m_entries.end(), [](ControlMapping const& a, ControlMapping const& b)
+                {
+                    return a.ReportId != b.ReportId ? a.ReportId < b.ReportId : a.Offset < b.Offset;
+                });
+
+            size_t index = 0;
+            for (size_t reportId = 0; reportId < 256; reportId++)
+            {
+                m_reportStart[reportId] = static_cast<uint32_t>(index);
+                while (index < m_entries.size() && m_entries[index].ReportId == reportId)
+                    index++;
+            }
+            m_reportStart[256] = static_cast<uint32_t>(index);
+        }
+
+        size_t Size() const noexcept { return m_entries.size(); }
+        bool Empty() const noexcept { return m_entries.empty(); }
+        ControlMapping const& operator[](size_t index) const noexcept { return m_entries[index]; }
+
+        // Index of the first entry for a report ID; its entries run up to the start of the next report ID
+        size_t ReportStart(uint8_t reportId) const noexcept { return m_reportStart[reportId]; }
+        size_t ReportEnd(uint8_t reportId) const noexcept { return m_reportStart[reportId + 1]; }
+
+        // Number of report bytes a control is read from
+        static size_t ByteCount(ControlMapping const& mapping) noexcept
+        {
+            if (!UsesBit(mapping))
+                return mapping.Size;
+            if (mapping.Type == ControlType::Hat)
+                return (mapping.Bit + mapping.Size + 7) / 8;
+            return 1;
+        }
+
+        // Whether a control is read from a bit position rather than as a whole axis value
+        static bool UsesBit(ControlMapping const& mapping) noexcept
+        {
+            return mapping.Type != ControlType::Axis && mapping.Transform != ControlTransform::Threshold;
+        }
+    };
+
+    // Turns a stream of reports into button/axis/hat events using a compiled input map.
+    // The map is shared between devices, the last known control values are kept per mapper.
+    class EventMapper
+    {
+    private:
+        std::shared_ptr<const InputMap> m_map;
+        std::vector<int32_t> m_values;
+        std::vector<bool> m_known;
+        std::vector<bool> m_missing; // Past the end of a report, so not counted in m_unknownCount even though not known
+        size_t m_unknownCount = 0;
+
+    public:
+        EventMapper() = default;
+
+        // Switching to a different map is done by constructing a new mapper. Control values aren't carried over,
+        // so the first report afterwards sets a new baseline rather than generating events. That report is read in
+        // full whatever its change mask, so controls held since before the switch aren't missed.
+        explicit EventMapper(std::shared_ptr<const InputMap> map)
+            : m_map(std::move(map))
+        {
+            if (m_map)
+            {
+                m_values.resize(m_map->Size());
+                m_known.resize(m_map->Size());
+                m_missing.resize(m_map->Size());
+                m_unknownCount = m_map->Size();
+            }
+        }
+
+        bool Empty() const noexcept { return !m_map || m_map->Empty(); }
+        std::shared_ptr<const InputMap> const& Map() const noexcept { return m_map; }
+
+        // True once every control has a baseline or was past the end of its report, after which reports whose
+        // change mask is 0 are skipped without being read
+        bool Baselined() const noexcept { return m_unknownCount == 0; }
+
+        // Generates events for every mapped control whose state changed in the given report.
+        // changeMask is the result of ReportChangeMask against the previous report, and is used to skip
+        // controls whose bytes are unchanged, once they have a baseline.
+        void Process(uint64_t timestamp, uint8_t reportId, const uint8_t* data, size_t length,
+            uint64_t changeMask, EventQueue& queue)
+        {
+            if (Empty() || (changeMask == 0 && m_unknownCount == 0))
+                return;
+
+            for (size_t i = m_map->ReportStart(reportId); i < m_map->ReportEnd(reportId); i++)
+            {
+                ControlMapping const& mapping = (*m_map)[i];
+                if (m_known[i] && !MaybeChanged(mapping, changeMask))
+                    continue;
+
+                // A control past the end of the report stops counting as unknown, or unchanged reports would keep
+                // being read in full. It still takes its baseline from the first report long enough to hold it.
+                int32_t value;
+                if (!ReadValue(mapping, data, length, value))
+                {
+                    if (!m_known[i] && !m_missing[i])
+                    {
+                        m_missing[i] = true;
+                        m_unknownCount--;
+                    }
+                    continue;
+                }
+
+                // The first value seen is taken as the baseline
+                if (!m_known[i])
+                {
+                    m_known[i] = true;
+                    m_values[i] = value;
+                    if (!m_missing[i])
+                        m_unknownCount--;
+                    continue;
+                }
+
+                int32_t previous = m_values[i];
+                m_values[i] = value;
+                if (value == previous)
+                    continue;
+
+                switch (mapping.Type)
+                {
+                case ControlType::Button:
+                    queue.Push({ timestamp, value ? EventType::ButtonPressed : EventType::ButtonReleased,
+                        mapping.Control, value });
+                    break;
+                case ControlType::Axis:
+                {
+                    bool wasAbove = previous >= mapping.Threshold;
+                    bool isAbove = value >= mapping.Threshold;
+                    if (wasAbove != isAbove)
+                    {
+                        queue.Push({ timestamp, isAbove ? EventType::AxisAboveThreshold : EventType::AxisBelowThreshold,
+                            mapping.Control, value });
+                    }
+                    break;
+                }
+                case ControlType::Hat:
+                    queue.Push({ timestamp, EventType::HatChanged, mapping.Control, value });
+                    break;
+                }
+            }
+        }
+
+        // Writes the last known value of each mapped control into a state slot, indexed by the control index.
+        // Buttons are set as bits in buttons, axes and hats are written into their respective arrays.
+        void WriteState(uint64_t& buttons, int32_t* axes, size_t axisCount, uint8_t* hats, size_t hatCount) const noexcept
+        {
+            if (Empty())
+                return;
+
+            for (size_t i = 0; i < m_map->Size(); i++)
+            {
+                ControlMapping const& mapping = (*m_map)[i];
+                if (!m_known[i])
+                    continue;
+
+                switch (mapping.Type)
+                {
+                case ControlType::Button:
+                    if (mapping.Control < 64)
+                    {
+                        uint64_t bit = 1ull << mapping.Control;
+                        buttons = m_values[i] ? (buttons | bit) : (buttons & ~bit);
+                    }
+                    break;
+                case ControlType::Axis:
+                    if (mapping.Control < axisCount)
+                        axes[mapping.Control] = m_values[i];
+                    break;
+                case ControlType::Hat:
+                    if (mapping.Control < hatCount)
+                        hats[mapping.Control] = static_cast<uint8_t>(m_values[i]);
+                    break;
+                }
+            }
+        }
+
+    private:
+        static bool MaybeChanged(ControlMapping const& mapping, uint64_t changeMask) noexcept
+        {
+            size_t first = mapping.Offset;
+            size_t last = first + InputMap::ByteCount(mapping) - 1;
+            if (last >= 63)
+                return (changeMask >> (first < 63 ? first : 63)) != 0;
+
+            uint64_t bytes = ((2ull << last) - 1) & ~((1ull << first) - 1);
+            return (changeMask & bytes) != 0;
+        }
+
+        static bool ReadValue(ControlMapping const& mapping, const uint8_t* data, size_t length, int32_t& value) noexcept
+        {
+            size_t byteCount = InputMap::ByteCount(mapping);
+            if (mapping.Offset + byteCount > length)
+                return false;
+
+            // Reports are little-endian
+            uint32_t raw = 0;
+            for (size_t i = 0; i < byteCount; i++)
+            {
+                raw |= static_cast<uint32_t>(data[mapping.Offset + i]) << (i * 8);
+            }
+
+            if (mapping.Type == ControlType::Hat)
+            {
+                value = static_cast<int32_t>((raw >> mapping.Bit) & (mapping.Size < 32 ? (1u << mapping.Size) - 1 : ~0u));
+                return true;
+            }
+
+            if (mapping.Type == ControlType::Button && mapping.Transform != ControlTransform::Threshold)
+            {
+                value = (raw >> mapping.Bit) & 1;
+                if (mapping.Transform == ControlTransform::Invert)
+                    value ^= 1;
+                return true;
+            }
+
+            if (mapping.Transform == ControlTransform::Invert)
+            {
+                // Mirrors the value within its range: 0 <-> max for unsigned, min <-> max for signed
+                raw = ~raw & (byteCount < 4 ? (1u << (byteCount * 8)) - 1 : ~0u);
+            }
+
+            if (mapping.Signed && byteCount < 4)
+            {
+                // Sign-extend
+                uint32_t signBit = 1u << (byteCount * 8 - 1);
+                value = static_cast<int32_t>((raw ^ signBit) - signBit);
+            }
+            else
+            {
+                value = static_cast<int32_t>(raw);
+            }
+
+            if (mapping.Type == ControlType::Button)
+                value = value >= mapping.Threshold ? 1 : 0;
+            return true;
+        }
+    };
+}
@@ -0,0 +1,247 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+// winsock2.h has to come before windows.h, which pch.h takes care of
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace winrt::WGIC::Core
+{
+    // Minimal stream socket on a local (AF_UNIX) address, which Windows 10 supports as well as POSIX systems
+    class LocalSocket
+    {
+    public:
+#ifdef _WIN32
+        using native_handle = SOCKET;
+        static constexpr native_handle InvalidHandle = INVALID_SOCKET;
+#else
+        using native_handle = int;
+        static constexpr native_handle InvalidHandle = -1;
+#endif
+
+    private:
+        native_handle m_handle = InvalidHandle;
+
+        explicit LocalSocket(native_handle handle) noexcept
+            : m_handle(handle)
+        {
+        }
+
+    public:
+        LocalSocket() = default;
+        LocalSocket(LocalSocket const&) = delete;
+        LocalSocket& operator=(LocalSocket const&) = delete;
+
+        LocalSocket(LocalSocket&& other) noexcept
+            : m_handle(std::exchange(other.m_handle, InvalidHandle))
+        {
+        }
+
+        LocalSocket& operator=(LocalSocket&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                m_handle = std::exchange(other.m_handle, InvalidHandle);
+            }
+
+            return *this;
+        }
+
+        ~LocalSocket()
+        {
+            Close();
+        }
+
+        bool IsOpen() const noexcept { return m_handle != InvalidHandle; }
+
+        // Listens on a path, replacing a stale socket file left behind at it, but failing if something is still
+        // listening there. The socket is non-blocking.
+        bool Listen(std::string const& path, int backlog = 8)
+        {
+            sockaddr_un address {};
+            if (!MakeAddress(path, address) || InUse(path) || !Open())
+                return Fail();
+
+            Unlink(path);
+            if (bind(m_handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+                listen(m_handle, backlog) != 0)
+            {
+                return Fail();
+            }
+
+            return SetNonBlocking();
+        }
+
+        // Accepts a pending connection as a non-blocking socket, or returns a closed socket if there are none
+        LocalSocket Accept() noexcept
+        {
+            LocalSocket client(accept(m_handle, nullptr, nullptr));
+            if (client.IsOpen())
+                client.SetNonBlocking();
+            return client;
+        }
+
+        // Connects to a listening path. The socket is blocking.
+        bool Connect(std::string const& path)
+        {
+            sockaddr_un address {};
+            if (!Open() || !MakeAddress(path, address) ||
+                connect(m_handle, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+            {
+                return Fail();
+            }
+
+            return true;
+        }
+
+        // Returns the number of bytes sent, 0 if a non-blocking socket's buffer is full, or -1 on error
+        int64_t Send(const uint8_t* data, size_t length) noexcept
+        {
+#ifdef _WIN32
+            int sent = send(m_handle, reinterpret_cast<const char*>(data), static_cast<int>(length), 0);
+            if (sent == SOCKET_ERROR)
+                return WSAGetLastError() == WSAEWOULDBLOCK ? 0 : -1;
+#else
+            ssize_t sent = send(m_handle, data, length, MSG_NOSIGNAL);
+            if (sent < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+#endif
+            return sent;
+        }
+
+        // For a non-blocking socket that the other end isn't expected to send anything on: discards whatever has
+        // arrived, and returns false once the other end has closed or the connection has failed
+        bool CheckOpen() noexcept
+        {
+            uint8_t discarded[256];
+            while (true)
+            {
+#ifdef _WIN32
+                int received = recv(m_handle, reinterpret_cast<char*>(discarded), sizeof(discarded), 0);
+                if (received == SOCKET_ERROR)
+                    return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+                ssize_t received = recv(m_handle, discarded, sizeof(discarded), 0);
+                if (received < 0)
+                    return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+                if (received == 0)
+                    return false;
+            }
+        }
+
+        // Returns the number of bytes received, or 0 once the other end has closed (or on error)
+        int64_t Receive(uint8_t* data, size_t length) noexcept
+        {
+#ifdef _WIN32
+            int received = recv(m_handle, reinterpret_cast<char*>(data), static_cast<int>(length), 0);
+#else
+            ssize_t received = recv(m_handle, data, length, 0);
+#endif
+            return received > 0 ? received : 0;
+        }
+
+        // Receives exactly length bytes, returning false if the connection ends first
+        bool ReceiveAll(uint8_t* data, size_t length) noexcept
+        {
+            while (length > 0)
+            {
+                int64_t received = Receive(data, length);
+                if (received <= 0)
+                    return false;
+
+                data += received;
+                length -= static_cast<size_t>(received);
+            }
+
+            return true;
+        }
+
+        void Close() noexcept
+        {
+            if (m_handle == InvalidHandle)
+                return;
+
+#ifdef _WIN32
+            closesocket(m_handle);
+#else
+            close(m_handle);
+#endif
+            m_handle = InvalidHandle;
+        }
+
+        static void Unlink(std::string const& path) noexcept
+        {
+#ifdef _WIN32
+            DeleteFileA(path.c_str());
+#else
+            unlink(path.c_str());
+#endif
+        }
+
+        // Whether something is listening on a path. A socket file whose listener has gone refuses connections.
+        static bool InUse(std::string const& path)
+        {
+            LocalSocket probe;
+            return probe.Connect(path);
+        }
+
+    private:
+        bool Open() noexcept
+        {
+            Close();
+#ifdef _WIN32
+            static std::once_flag startup;
+            std::call_once(startup, []
+            {
+                WSADATA data;
+                WSAStartup(MAKEWORD(2, 2), &data);
+            });
+#endif
+            m_handle = socket(AF_UNIX, SOCK_STREAM, 0);
+            return IsOpen();
+        }
+
+        bool SetNonBlocking() noexcept
+        {
+#ifdef _WIN32
+            u_long enabled = 1;
+            return ioctlsocket(m_handle, FIONBIO, &enabled) == 0;
+#else
+            int flags = fcntl(m_handle, F_GETFL, 0);
+            return flags >= 0 && fcntl(m_handle, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+        }
+
+        bool Fail() noexcept
+        {
+            Close();
+            return false;
+        }
+
+        static bool MakeAddress(std::string const& path, sockaddr_un& address) noexcept
+        {
+            if (path.empty() || path.size() >= sizeof(address.sun_path))
+                return false;
+
+            address.sun_family = AF_UNIX;
+            memcpy(address.sun_path, path.data(), path.size());
+            return true;
+        }
+    };
+}
@@ -0,0 +1,166 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace winrt::WGIC::Core
+{
+    // A file mapped into memory. Writes go straight to the OS's copy of the file, so anything written is kept
+    // even if the process crashes before closing it.
+    class MappedFile
+    {
+    private:
+        void* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_file = INVALID_HANDLE_VALUE;
+        HANDLE m_mapping = nullptr;
+#endif
+
+    public:
+        MappedFile() = default;
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        MappedFile(MappedFile&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        MappedFile& operator=(MappedFile&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+#ifdef _WIN32
+                std::swap(m_file, other.m_file);
+                std::swap(m_mapping, other.m_mapping);
+#endif
+            }
+
+            return *this;
+        }
+
+        ~MappedFile()
+        {
+            Close();
+        }
+
+        void* Data() const noexcept { return m_data; }
+        size_t Size() const noexcept { return m_size; }
+        bool IsOpen() const noexcept { return m_data != nullptr; }
+
+        // Creates or replaces a file of the given size, zero-filled, and maps it writable
+        bool Create(std::string const& path, size_t size)
+        {
+            Close();
+#ifdef _WIN32
+            std::wstring widePath = Widen(path);
+            m_file = CreateFile2(widePath.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, CREATE_ALWAYS, nullptr);
+            if (m_file != INVALID_HANDLE_VALUE)
+                m_mapping = CreateFileMappingFromApp(m_file, nullptr, PAGE_READWRITE, size, nullptr);
+            if (m_mapping)
+                m_data = MapViewOfFileFromApp(m_mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, size);
+#else
+            int fd = open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+            if (fd < 0)
+                return false;
+
+            if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            {
+                void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                m_data = data != MAP_FAILED ? data : nullptr;
+            }
+            close(fd);
+#endif
+            if (!m_data)
+            {
+                Close();
+                return false;
+            }
+
+            m_size = size;
+            return true;
+        }
+
+        // Maps an existing file read-only, even if another process still has it open for writing
+        bool Open(std::string const& path)
+        {
+            Close();
+#ifdef _WIN32
+            std::wstring widePath = Widen(path);
+            m_file = CreateFile2(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, nullptr);
+            LARGE_INTEGER size {};
+            if (m_file != INVALID_HANDLE_VALUE && GetFileSizeEx(m_file, &size) && size.QuadPart > 0)
+            {
+                m_mapping = CreateFileMappingFromApp(m_file, nullptr, PAGE_READONLY, 0, nullptr);
+                if (m_mapping)
+                    m_data = MapViewOfFileFromApp(m_mapping, FILE_MAP_READ, 0, 0);
+                m_size = static_cast<size_t>(size.QuadPart);
+            }
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+
+            struct stat info {};
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                m_data = data != MAP_FAILED ? data : nullptr;
+                m_size = static_cast<size_t>(info.st_size);
+            }
+            close(fd);
+#endif
+            if (!m_data)
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (m_data)
+                UnmapViewOfFile(m_data);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            if (m_file != INVALID_HANDLE_VALUE)
+                CloseHandle(m_file);
+            m_mapping = nullptr;
+            m_file = INVALID_HANDLE_VALUE;
+#else
+            if (m_data)
+                munmap(m_data, m_size);
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+    private:
+#ifdef _WIN32
+        static std::wstring Widen(std::string const& path)
+        {
+            int length = MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), nullptr, 0);
+            std::wstring wide(static_cast<size_t>(length), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), wide.data(), length);
+            return wide;
+        }
+#endif
+    };
+}
@@ -0,0 +1,421 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    class ReportArchive;
+
+    // A run of encoded reports which can be decoded on its own, since its first report is stored in full.
+    // Each report starts with varint (timestamp delta << 2 | flags), followed by the report ID if flag 1 is set
+    // and a varint length if flag 2 is set; otherwise they're the same as the previous report's. The first report's
+    // data follows as-is, and every later report's as
+    //   (varint (unchanged bytes << 1 | last), varint changed bytes, changed bytes XOR previous report)...
+    // where everything after the run marked last is unchanged. Bytes past the end of the previous report count as 0,
+    // so an unchanged report takes 3-4 bytes.
+    struct ArchiveBlock
+    {
+        uint64_t FirstTimestamp = 0;
+        uint64_t LastTimestamp = 0;
+        uint32_t Count = 0;
+        std::vector<uint8_t> Data;
+    };
+
+    // Walks the reports in a block, oldest first
+    class ArchiveBlockReader
+    {
+    private:
+        const uint8_t* m_position;
+        const uint8_t* m_end;
+        uint32_t m_remaining;
+        uint64_t m_timestamp;
+        bool m_keyframe = true;
+        uint8_t m_reportId = 0;
+        std::vector<uint8_t> m_report;
+
+    public:
+        explicit ArchiveBlockReader(ArchiveBlock const& block)
+            : m_position(block.Data.data()), m_end(block.Data.data() + block.Data.size()), m_remaining(block.Count),
+            m_timestamp(block.FirstTimestamp)
+        {
+        }
+
+        // The data stays valid until the next call. Returns false at the end of the block.
+        bool Next(uint64_t& timestamp, uint8_t& reportId, const uint8_t*& data, size_t& length)
+        {
+            if (m_remaining == 0)
+                return false;
+
+            uint64_t header, size = m_report.size();
+            if (!ReadVarint(header) || (m_keyframe && (header & 3) != 3))
+                return Fail();
+            if (header & 1)
+            {
+                if (m_position >= m_end)
+                    return Fail();
+                m_reportId = *m_position++;
+            }
+            if ((header & 2) && !ReadVarint(size))
+                return Fail();
+
+            reportId = m_reportId;
+            length = static_cast<size_t>(size);
+            if (m_keyframe)
+            {
+                m_keyframe = false;
+                if (static_cast<size_t>(m_end - m_position) < length)
+                    return Fail();
+
+                m_report.assign(m_position, m_position + length);
+                m_position += length;
+            }
+            else
+            {
+                m_report.resize(length);
+                for (size_t offset = 0;;)
+                {
+                    uint64_t run, changed;
+                    if (!ReadVarint(run) || !ReadVarint(changed) || (run >> 1) + changed > length - offset ||
+                        static_cast<uint64_t>(m_end - m_position) < changed || (run == 0 && changed == 0))
+                    {
+                        return Fail();
+                    }
+
+                    offset += static_cast<size_t>(run >> 1);
+                    for (uint64_t i = 0; i < changed; i++)
+                        m_report[offset++] ^= *m_position++;
+                    if (run & 1)
+                        break;
+                }
+            }
+
+            m_timestamp += header >> 2;
+            m_remaining--;
+            timestamp = m_timestamp;
+            data = m_report.data();
+            return true;
+        }
+
+    private:
+        bool ReadVarint(uint64_t& value) noexcept
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && m_position < m_end; shift += 7)
+            {
+                uint8_t byte = *m_position++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0)
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool Fail() noexcept
+        {
+            m_remaining = 0;
+            return false;
+        }
+    };
+
+    // Caps the total size of every archive it's shared by, evicting the oldest blocks across all of them
+    class ArchiveBudget
+    {
+        friend class ReportArchive;
+
+    private:
+        std::mutex m_lock;
+        std::vector<std::weak_ptr<ReportArchive>> m_archives;
+        std::atomic<uint64_t> m_limit;
+        std::atomic<uint64_t> m_used { 0 };
+        std::atomic<uint64_t> m_evicted { 0 };
+
+    public:
+        explicit ArchiveBudget(uint64_t limit)
+            : m_limit(limit)
+        {
+        }
+
+        uint64_t Limit() const noexcept { return m_limit.load(std::memory_order_relaxed); }
+        uint64_t Used() const noexcept { return m_used.load(std::memory_order_relaxed); }
+        uint64_t EvictedBlocks() const noexcept { return m_evicted.load(std::memory_order_relaxed); }
+
+        void SetLimit(uint64_t limit)
+        {
+            m_limit.store(limit, std::memory_order_relaxed);
+            Enforce();
+        }
+
+        // Evicts the oldest sealed blocks until the archives fit in the limit, or only their newest blocks are left
+        inline void Enforce();
+
+    private:
+        void Add(std::weak_ptr<ReportArchive> archive)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_archives.push_back(std::move(archive));
+        }
+
+        void Charge(int64_t bytes) noexcept
+        {
+            m_used.fetch_add(static_cast<uint64_t>(bytes), std::memory_order_relaxed);
+        }
+    };
+
+    // Long-term report history for one device, kept compact by storing each report as the difference from the one
+    // before it. Reports are grouped into blocks of up to keyframeInterval reports; only whole sealed blocks are
+    // evicted, and a lookup only needs to decode the blocks it covers.
+    // Appending and reading may happen on different threads. Readers copy out the blocks they need and decode them
+    // without the lock, so a long read doesn't hold up the input sink.
+    class ReportArchive
+    {
+        friend class ArchiveBudget;
+
+    private:
+        std::shared_ptr<ArchiveBudget> m_budget;
+        uint32_t m_keyframeInterval;
+
+        mutable std::mutex m_lock;
+        std::deque<std::shared_ptr<const ArchiveBlock>> m_sealed;
+        ArchiveBlock m_active;
+        uint64_t m_size = 0;
+        std::vector<uint8_t> m_previous;
+        uint8_t m_previousId = 0;
+        // Of the newest report, which may be in a sealed block rather than the active one
+        bool m_hasReports = false;
+        uint64_t m_lastTimestamp = 0;
+
+        struct Token {};
+
+    public:
+        // Archives must be created with Create so the budget can find them
+        ReportArchive(Token, std::shared_ptr<ArchiveBudget> budget, uint32_t keyframeInterval)
+            : m_budget(std::move(budget)), m_keyframeInterval(std::max<uint32_t>(keyframeInterval, 1))
+        {
+        }
+
+        ~ReportArchive()
+        {
+            m_budget->Charge(-static_cast<int64_t>(m_size));
+        }
+
+        static std::shared_ptr<ReportArchive> Create(std::shared_ptr<ArchiveBudget> budget, uint32_t keyframeInterval)
+        {
+            auto archive = std::make_shared<ReportArchive>(Token {}, budget, keyframeInterval);
+            budget->Add(archive);
+            return archive;
+        }
+
+        // Bytes used by the encoded reports
+        uint64_t Size() const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_size;
+        }
+
+        // Must only ever be called by one thread at a time. If the timestamp goes backwards, which only happens if
+        // the time base was reset, everything archived so far is discarded.
+        void Append(uint64_t timestamp, uint8_t reportId, const uint8_t* data, size_t length)
+        {
+            bool sealed;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                int64_t before = static_cast<int64_t>(m_size);
+                if (m_hasReports && timestamp < m_lastTimestamp)
+                    Clear();
+
+                sealed = AppendLocked(timestamp, reportId, data, length);
+                m_budget->Charge(static_cast<int64_t>(m_size) - before);
+            }
+
+            if (sealed && m_budget->Used() > m_budget->Limit())
+                m_budget->Enforce();
+        }
+
+        // Calls func(timestamp, reportId, data, length) for every report with a timestamp in [from, to], oldest
+        // first, returning false from func to stop early
+        template<typename TFunc>
+        void ForEach(uint64_t from, uint64_t to, TFunc&& func) const
+        {
+            std::vector<std::shared_ptr<const ArchiveBlock>> blocks;
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                auto first = std::partition_point(m_sealed.begin(), m_sealed.end(),
+                    [from](auto const& block) { return block->LastTimestamp < from; });
+                for (auto block = first; block != m_sealed.end() && (*block)->FirstTimestamp <= to; ++block)
+                    blocks.push_back(*block);
+
+                if (m_active.Count > 0 && m_active.LastTimestamp >= from && m_active.FirstTimestamp <= to)
+                    blocks.push_back(std::make_shared<const ArchiveBlock>(m_active));
+            }
+
+            for (auto const& block : blocks)
+            {
+                ArchiveBlockReader reader(*block);
+                uint64_t timestamp;
+                uint8_t reportId;
+                const uint8_t* data;
+                size_t length;
+                while (reader.Next(timestamp, reportId, data, length))
+                {
+                    if (timestamp > to)
+                        return;
+                    if (timestamp >= from && !func(timestamp, reportId, data, length))
+                        return;
+                }
+            }
+        }
+
+    private:
+        // Returns true if this sealed the active block
+        bool AppendLocked(uint64_t timestamp, uint8_t reportId, const uint8_t* data, size_t length)
+        {
+            auto& out = m_active.Data;
+            size_t before = out.size();
+            if (m_active.Count == 0)
+            {
+                m_active.FirstTimestamp = timestamp;
+                m_active.LastTimestamp = timestamp;
+                WriteVarint(out, 3);
+                out.push_back(reportId);
+                WriteVarint(out, length);
+                out.insert(out.end(), data, data + length);
+            }
+            else
+            {
+                bool newId = reportId != m_previousId;
+                bool newLength = length != m_previous.size();
+                WriteVarint(out, ((timestamp - m_active.LastTimestamp) << 2) | (newLength ? 2 : 0) | (newId ? 1 : 0));
+                if (newId)
+                    out.push_back(reportId);
+                if (newLength)
+                    WriteVarint(out, length);
+                WriteDelta(out, data, length);
+                m_active.LastTimestamp = timestamp;
+            }
+
+            m_previous.assign(data, data + length);
+            m_previousId = reportId;
+            m_hasReports = true;
+            m_lastTimestamp = timestamp;
+            m_active.Count++;
+            m_size += out.size() - before;
+
+            if (m_active.Count < m_keyframeInterval)
+                return false;
+
+            m_active.Data.shrink_to_fit();
+            m_sealed.push_back(std::make_shared<const ArchiveBlock>(std::move(m_active)));
+            m_active = {};
+            m_active.Data.reserve(m_sealed.back()->Data.size());
+            return true;
+        }
+
+        void WriteDelta(std::vector<uint8_t>& out, const uint8_t* data, size_t length) const
+        {
+            auto changedAt = [&](size_t i) { return data[i] != (i < m_previous.size() ? m_previous[i] : 0); };
+
+            // Nothing needs storing after the last changed byte
+            size_t end = length;
+            while (end > 0 && !changedAt(end - 1))
+                end--;
+
+            size_t offset = 0;
+            do
+            {
+                size_t start = offset;
+                while (offset < end && !changedAt(offset))
+                    offset++;
+                size_t unchanged = offset - start;
+
+                // A single unchanged byte between changes is cheaper to store than to start a new run for
+                start = offset;
+                while (offset < end && (changedAt(offset) || (offset + 1 < end && changedAt(offset + 1))))
+                    offset++;
+
+                WriteVarint(out, (unchanged << 1) | (offset == end ? 1 : 0));
+                WriteVarint(out, offset - start);
+                for (size_t i = start; i < offset; i++)
+                    out.push_back(static_cast<uint8_t>(data[i] ^ (i < m_previous.size() ? m_previous[i] : 0)));
+            } while (offset < end);
+        }
+
+        static void WriteVarint(std::vector<uint8_t>& out, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        // Must be called with the lock held
+        void Clear()
+        {
+            m_sealed.clear();
+            m_active = {};
+            m_previous.clear();
+            m_hasReports = false;
+            m_size = 0;
+        }
+
+        bool OldestSealed(uint64_t& timestamp) const
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_sealed.empty())
+                return false;
+
+            timestamp = m_sealed.front()->FirstTimestamp;
+            return true;
+        }
+
+        void EvictOldest()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_sealed.empty())
+                return;
+
+            uint64_t size = m_sealed.front()->Data.size();
+            m_sealed.pop_front();
+            m_size -= size;
+            m_budget->Charge(-static_cast<int64_t>(size));
+        }
+    };
+
+    void ArchiveBudget::Enforce()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_archives.erase(std::remove_if(m_archives.begin(), m_archives.end(),
+            [](auto const& archive) { return archive.expired(); }), m_archives.end());
+
+        while (Used() > Limit())
+        {
+            // Report timestamps share a time base across devices, so this is the oldest data overall
+            std::shared_ptr<ReportArchive> oldest;
+            uint64_t oldestTimestamp = UINT64_MAX;
+            for (auto const& entry : m_archives)
+            {
+                uint64_t timestamp;
+                auto archive = entry.lock();
+                if (archive && archive->OldestSealed(timestamp) && timestamp <= oldestTimestamp)
+                {
+                    oldest = std::move(archive);
+                    oldestTimestamp = timestamp;
+                }
+            }
+
+            if (!oldest)
+                return;
+
+            oldest->EvictOldest();
+            m_evicted.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,27 @@
+#include "pch.h"
+#include "WGIC/ReportArchiveBudget.h"
+#include "WGIC.ReportArchiveBudget.g.cpp"
+#include "WGIC/DeviceFactory.h"
+
+namespace winrt::WGIC::implementation
+{
+    uint64_t ReportArchiveBudget::Limit()
+    {
+        return DeviceFactory::ArchiveBudget()->Limit();
+    }
+
+    void ReportArchiveBudget::SetLimit(uint64_t limit)
+    {
+        DeviceFactory::ArchiveBudget()->SetLimit(limit);
+    }
+
+    uint64_t ReportArchiveBudget::Used()
+    {
+        return DeviceFactory::ArchiveBudget()->Used();
+    }
+
+    uint64_t ReportArchiveBudget::EvictedBlocks()
+    {
+        return DeviceFactory::ArchiveBudget()->EvictedBlocks();
+    }
+}
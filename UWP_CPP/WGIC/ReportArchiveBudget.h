@@ -0,0 +1,23 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.ReportArchiveBudget.g.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct ReportArchiveBudget
+    {
+    public:
+        static uint64_t Limit();
+        static void SetLimit(uint64_t limit);
+
+        static uint64_t Used();
+        static uint64_t EvictedBlocks();
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct ReportArchiveBudget : ReportArchiveBudgetT<ReportArchiveBudget, implementation::ReportArchiveBudget>
+    {
+    };
+}
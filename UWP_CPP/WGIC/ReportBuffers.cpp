@@ -0,0 +1,45 @@
+#include "pch.h"
+#include "WGIC/ReportBuffers.h"
+#include "WGIC.ReportBuffers.g.cpp"
+#include "WGIC/DeviceFactory.h"
+
+namespace winrt::WGIC::implementation
+{
+    uint64_t ReportBuffers::Limit()
+    {
+        return DeviceFactory::Buffers().GetStatistics().Limit;
+    }
+
+    void ReportBuffers::SetLimit(uint64_t limit)
+    {
+        DeviceFactory::Buffers().SetLimit(limit);
+    }
+
+    uint64_t ReportBuffers::DeviceLimit()
+    {
+        return DeviceFactory::DeviceBufferLimit();
+    }
+
+    void ReportBuffers::SetDeviceLimit(uint64_t limit)
+    {
+        DeviceFactory::DeviceBufferLimit(limit);
+    }
+
+    WGIC::ReportBufferStatistics ReportBuffers::GetStatistics()
+    {
+        auto statistics = DeviceFactory::Buffers().GetStatistics();
+        return {
+            statistics.Used,
+            statistics.Peak,
+            statistics.Limit,
+            statistics.Reserved,
+            statistics.Buffers,
+            statistics.FailedAllocations
+        };
+    }
+
+    void ReportBuffers::ResetPeak()
+    {
+        DeviceFactory::Buffers().ResetPeak();
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.ReportBuffers.g.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct ReportBuffers
+    {
+    public:
+        static uint64_t Limit();
+        static void SetLimit(uint64_t limit);
+
+        static uint64_t DeviceLimit();
+        static void SetDeviceLimit(uint64_t limit);
+
+        static WGIC::ReportBufferStatistics GetStatistics();
+        static void ResetPeak();
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct ReportBuffers : ReportBuffersT<ReportBuffers, implementation::ReportBuffers>
+    {
+    };
+}
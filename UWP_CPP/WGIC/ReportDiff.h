@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define WGIC_REPORT_DIFF_SSE2
+#endif
+
+namespace winrt::WGIC::Core
+{
+    // ReportChangeMask for reports of the same length, 8 bytes at a time: skips over identical words without
+    // checking each byte. Used where SSE2 isn't available.
+    inline uint64_t ReportChangeMaskScalar(const uint8_t* previous, const uint8_t* current, size_t length) noexcept
+    {
+        uint64_t mask = 0;
+        size_t index = 0;
+        for (; index + 8 <= length; index += 8)
+        {
+            uint64_t a, b;
+            memcpy(&a, previous + index, sizeof(a));
+            memcpy(&b, current + index, sizeof(b));
+            if (a == b)
+                continue;
+
+            for (size_t i = index; i < index + 8; i++)
+            {
+                if (previous[i] != current[i])
+                    mask |= 1ull << (i < 63 ? i : 63);
+            }
+        }
+
+        for (; index < length; index++)
+        {
+            if (previous[index] != current[index])
+                mask |= 1ull << (index < 63 ? index : 63);
+        }
+
+        return mask;
+    }
+
+#ifdef WGIC_REPORT_DIFF_SSE2
+    // ReportChangeMask for reports of the same length, 16 bytes at a time: compares for equality, then inverts the
+    // resulting per-byte mask
+    inline uint64_t ReportChangeMaskSse2(const uint8_t* previous, const uint8_t* current, size_t length) noexcept
+    {
+        uint64_t mask = 0;
+        size_t index = 0;
+        for (; index + 16 <= length; index += 16)
+        {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + index));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + index));
+            uint64_t changed = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFF;
+
+            if (index < 64)
+                mask |= changed << index;
+            else if (changed)
+                mask |= 1ull << 63;
+        }
+
+        // Then 8 more if there are, so short reports don't fall back to comparing every byte
+        if (index + 8 <= length)
+        {
+            __m128i a = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(previous + index));
+            __m128i b = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(current + index));
+            uint64_t changed = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFF;
+
+            if (index < 64)
+                mask |= changed << index;
+            else if (changed)
+                mask |= 1ull << 63;
+            index += 8;
+        }
+
+        for (; index < length; index++)
+        {
+            if (previous[index] != current[index])
+                mask |= 1ull << (index < 63 ? index : 63);
+        }
+
+        return mask;
+    }
+#endif
+
+    // Computes a mask of which bytes differ between two reports: bit N is set if byte N changed.
+    // Reports longer than 64 bytes have all changes at byte 63 and beyond folded into bit 63.
+    // If the lengths differ, every bit is set. A result of 0 means the reports are identical.
+    inline uint64_t ReportChangeMask(const uint8_t* previous, size_t previousLength,
+        const uint8_t* current, size_t currentLength) noexcept
+    {
+        if (previousLength != currentLength)
+            return ~0ull;
+
+#ifdef WGIC_REPORT_DIFF_SSE2
+        return ReportChangeMaskSse2(previous, current, currentLength);
+#else
+        return ReportChangeMaskScalar(previous, current, currentLength);
+#endif
+    }
+}
@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "WGIC/ReportExporter.h"
+#include "WGIC.ReportExporter.g.cpp"
+
+namespace winrt::WGIC::implementation
+{
+    std::mutex ReportExporter::s_lock;
+    std::atomic<bool> ReportExporter::s_running { false };
+    Core::SharedMemory ReportExporter::s_memory;
+    Core::BroadcastRing ReportExporter::s_ring;
+
+    void ReportExporter::Start(winrt::hstring const& name, uint32_t slotCount, uint32_t maxReportSize)
+    {
+        auto logger = spdlog::get(s_loggerName)->clone("ReportExporter::Start");
+
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (s_ring.IsValid())
+        {
+            logger->error("Already running!");
+            throw winrt::hresult_illegal_method_call();
+        }
+
+        if (name.empty() || slotCount == 0 || (slotCount & (slotCount - 1)) != 0 || maxReportSize > UINT16_MAX)
+        {
+            logger->error("Invalid ring parameters!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        if (!s_memory.Create(winrt::to_string(name), Core::BroadcastRing::RequiredSize(slotCount, maxReportSize)) ||
+            !s_ring.Initialize(s_memory.Data(), s_memory.Size(), slotCount, maxReportSize))
+        {
+            logger->error("Failed to create shared memory!");
+            s_memory.Close();
+            throw winrt::hresult_error(E_FAIL);
+        }
+
+        s_running.store(true, std::memory_order_relaxed);
+        logger->debug("Exporting reports to {}", winrt::to_string(name));
+    }
+
+    void ReportExporter::Stop()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        s_running.store(false, std::memory_order_relaxed);
+        s_ring = Core::BroadcastRing();
+        s_memory.Close();
+    }
+
+    bool ReportExporter::IsRunning()
+    {
+        return s_running.load(std::memory_order_relaxed);
+    }
+
+    uint64_t ReportExporter::Published()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        return s_ring.IsValid() ? s_ring.WriteSequence() : 0;
+    }
+}
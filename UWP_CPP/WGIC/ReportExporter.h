@@ -0,0 +1,46 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.ReportExporter.g.h"
+#include "WGIC/BroadcastRing.h"
+#include "WGIC/SharedMemory.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct ReportExporter
+    {
+    private:
+        static std::mutex s_lock;
+        static std::atomic<bool> s_running;
+        static Core::SharedMemory s_memory;
+        static Core::BroadcastRing s_ring;
+
+    public:
+        static void Start(winrt::hstring const& name, uint32_t slotCount, uint32_t maxReportSize);
+        static void Stop();
+
+        static bool IsRunning();
+        static uint64_t Published();
+
+        // Called for every report, from whichever pool worker is processing the device
+        static void Publish(Core::ReportRecord const& record, winrt::array_view<uint8_t const> data)
+        {
+            // While exporting is off, this check is all a report costs
+            if (!s_running.load(std::memory_order_relaxed))
+                return;
+
+            // While it's on, every report from every device takes this one lock, since the shared ring has a single
+            // writer and external readers follow it in order. Workers processing different devices wait on each other
+            // here for the length of a ring publish, which is a copy of at most maxReportSize bytes.
+            std::lock_guard<std::mutex> lock(s_lock);
+            if (s_ring.IsValid())
+                s_ring.Publish(record, data.data(), data.size());
+        }
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct ReportExporter : ReportExporterT<ReportExporter, implementation::ReportExporter>
+    {
+    };
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "WGIC/SpscQueue.h"
+#include "WGIC/WorkerPool.h"
+
+namespace winrt::WGIC::Core
+{
+    // A report as the input sink received it, followed in the queue by Length bytes of report data
+    struct QueuedReport
+    {
+        uint64_t Timestamp;
+        uint64_t ArrivalTime;   // Host time the sink received it, from HostMicroseconds
+        // The earliest-arriving of the reports skipped as idle since the last one queued, only kept for clock
+        // alignment. SkippedArrivalTime is 0 if there weren't any.
+        uint64_t SkippedTimestamp;
+        uint64_t SkippedArrivalTime;
+        uint64_t ChangeMask;
+        uint32_t Length;
+        uint8_t ReportId;
+        uint8_t MessageClass;
+        uint16_t Reserved;
+    };
+
+    // Carries a device's reports from its input sink to a worker pool, so the sink only has to copy each report.
+    // The handler runs on a pool thread and is never run for the same device on two threads at once, so reports
+    // are processed in the order they arrived.
+    class ReportQueue : public WorkerPool::Task, public std::enable_shared_from_this<ReportQueue>
+    {
+    public:
+        // Called with the queue to pop reports from; it should process what's there and return
+        using Handler = std::function<void(ReportQueue&)>;
+
+    private:
+        WorkerPool& m_pool;
+        SpscByteQueue m_queue;
+        std::atomic<bool> m_scheduled { false };
+        std::atomic<uint64_t> m_dropped { 0 };
+
+        std::mutex m_handlerLock; // Held while the handler runs
+        Handler m_handler;
+        std::atomic<std::thread::id> m_handlerThread {}; // The thread running the handler, if any
+        bool m_detached = false; // Detached from within the handler; guarded by m_handlerLock
+
+    public:
+        ReportQueue(WorkerPool& pool, size_t capacity, Handler handler)
+            : m_pool(pool), m_queue(capacity), m_handler(std::move(handler))
+        {
+        }
+
+        // Reports dropped because the queue was full
+        uint64_t Dropped() const noexcept { return m_dropped.load(std::memory_order_relaxed); }
+
+        // Must only ever be called by one thread at a time. Never blocks; if the workers have fallen so far behind
+        // that the queue is full, the report is dropped.
+        bool Push(QueuedReport const& report, const uint8_t* data)
+        {
+            if (!m_queue.Push(&report, sizeof(report), data, report.Length))
+            {
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            if (!m_scheduled.exchange(true, std::memory_order_seq_cst))
+                m_pool.Submit(shared_from_this());
+            return true;
+        }
+
+        // Consumer only, meaning from within the handler
+        bool Front(QueuedReport& report, const uint8_t*& data) noexcept
+        {
+            const uint8_t* entry;
+            size_t size;
+            if (!m_queue.Front(entry, size))
+                return false;
+
+            memcpy(&report, entry, sizeof(report));
+            data = entry + sizeof(report);
+            return true;
+        }
+
+        void Pop() noexcept
+        {
+            m_queue.Pop();
+        }
+
+        // Stops the handler from being called again, waiting for it to return if it's running.
+        // Must be called before whatever the handler refers to is destroyed. It may also be called from within the
+        // handler, such as when the handler drops the last reference to its device, in which case it returns
+        // straight away and the handler must not touch what it refers to afterwards.
+        void Detach()
+        {
+            // This thread already holds m_handlerLock, so waiting for it would never return
+            if (m_handlerThread.load(std::memory_order_relaxed) == std::this_thread::get_id())
+            {
+                m_detached = true;
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(m_handlerLock);
+            m_handler = nullptr;
+        }
+
+        void Run() override
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_handlerLock);
+                if (m_handler)
+                {
+                    m_handlerThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+                    m_handler(*this);
+                    m_handlerThread.store(std::thread::id(), std::memory_order_relaxed);
+
+                    // Only cleared now, since the handler was still running when it was detached
+                    if (m_detached)
+                        m_handler = nullptr;
+                }
+                else
+                {
+                    QueuedReport report;
+                    const uint8_t* data;
+                    while (Front(report, data))
+                        Pop();
+                }
+            }
+
+            // Anything pushed after the handler's last look at the queue, but before this, would otherwise be
+            // stranded, since the producer saw the queue as already scheduled
+            m_scheduled.store(false, std::memory_order_seq_cst);
+            if (!m_queue.Empty() && !m_scheduled.exchange(true, std::memory_order_seq_cst))
+                m_pool.Submit(shared_from_this());
+        }
+    };
+}
@@ -0,0 +1,288 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "WGIC/BroadcastRing.h"
+#include "WGIC/LocalSocket.h"
+
+namespace winrt::WGIC::Core
+{
+    // Every frame on a report stream starts with this header, followed by Length bytes of records.
+    // Each record is a ReportRecord followed by record.Length bytes of report data. All values are little-endian.
+    struct StreamFrameHeader
+    {
+        uint32_t Length;
+        uint32_t RecordCount;
+        uint32_t Sequence;      // Frame number for this client, which skips ahead over frames dropped for it
+        uint32_t LostReports;   // Reports the server itself couldn't keep up with, since it started
+    };
+
+    static_assert(sizeof(StreamFrameHeader) == 16 && sizeof(ReportRecord) == 24, "Stream layout must not change");
+
+    // Streams reports to any number of local clients, batching everything published during a flush interval into
+    // a single frame. Reports are published into a broadcast ring so the input sinks never wait on the network;
+    // each client has a bounded queue of frames, and a client that falls behind loses its oldest frames.
+    class StreamServer
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+    private:
+        struct Client
+        {
+            LocalSocket Socket;
+            std::deque<std::vector<uint8_t>> Frames;
+            size_t QueuedBytes = 0;
+            size_t SentOfFront = 0; // Bytes of the front frame already sent, which can't be dropped
+            uint32_t Sequence = 0;
+        };
+
+        std::string m_path;
+        clock::duration m_flushInterval;
+        size_t m_clientBufferSize;
+
+        std::mutex m_publishLock;
+        LocalBroadcastRing m_ring;
+
+        std::mutex m_stopLock;
+        std::condition_variable m_stopSignal;
+        bool m_stopping = false;
+        std::thread m_thread;
+        LocalSocket m_listener;
+
+        std::atomic<uint64_t> m_framesSent { 0 };
+        std::atomic<uint64_t> m_bytesSent { 0 };
+        std::atomic<uint64_t> m_framesDropped { 0 };
+        std::atomic<uint32_t> m_clientCount { 0 };
+
+    public:
+        StreamServer(std::string path, clock::duration flushInterval, size_t clientBufferSize,
+            uint32_t slotCount = 4096, uint32_t maxReportSize = 256)
+            : m_path(std::move(path)), m_flushInterval(flushInterval), m_clientBufferSize(clientBufferSize),
+            m_ring(slotCount, maxReportSize)
+        {
+        }
+
+        ~StreamServer()
+        {
+            Stop();
+        }
+
+        bool Start()
+        {
+            if (m_thread.joinable() || !m_ring.Ring().IsValid() || !m_listener.Listen(m_path))
+                return false;
+
+            m_stopping = false;
+            m_thread = std::thread(&StreamServer::Run, this);
+            return true;
+        }
+
+        void Stop()
+        {
+            if (!m_thread.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> lock(m_stopLock);
+                m_stopping = true;
+            }
+            m_stopSignal.notify_all();
+            m_thread.join();
+
+            m_listener.Close();
+            LocalSocket::Unlink(m_path);
+        }
+
+        // Safe to call from any thread; never blocks on clients
+        void Publish(ReportRecord const& record, const uint8_t* data, size_t length) noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_publishLock);
+            m_ring.Ring().Publish(record, data, length);
+        }
+
+        uint64_t FramesSent() const noexcept { return m_framesSent.load(std::memory_order_relaxed); }
+        uint64_t BytesSent() const noexcept { return m_bytesSent.load(std::memory_order_relaxed); }
+        uint64_t FramesDropped() const noexcept { return m_framesDropped.load(std::memory_order_relaxed); }
+
+        // Clients connected as of the last flush
+        uint32_t ClientCount() const noexcept { return m_clientCount.load(std::memory_order_relaxed); }
+
+    private:
+        void Run()
+        {
+            std::vector<Client> clients;
+            std::vector<uint8_t> batch;
+            std::vector<uint8_t> data(m_ring.Ring().DataSize());
+            BroadcastCursor cursor;
+            cursor.Reset(m_ring.Ring(), true);
+
+            clock::time_point nextFlush = clock::now() + m_flushInterval;
+            while (true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_stopLock);
+                    if (m_stopSignal.wait_until(lock, nextFlush, [this] { return m_stopping; }))
+                        break;
+                }
+                nextFlush += m_flushInterval;
+
+                for (LocalSocket socket = m_listener.Accept(); socket.IsOpen(); socket = m_listener.Accept())
+                {
+                    clients.emplace_back();
+                    clients.back().Socket = std::move(socket);
+                }
+
+                uint32_t count = BuildBatch(cursor, batch, data);
+                if (count > 0)
+                {
+                    for (auto& client : clients)
+                        Enqueue(client, batch, count, cursor.Lost());
+                }
+
+                // Clients that have disconnected are noticed here even when there's nothing to send them
+                for (size_t i = 0; i < clients.size();)
+                {
+                    if (clients[i].Socket.CheckOpen() && Flush(clients[i]))
+                    {
+                        i++;
+                    }
+                    else
+                    {
+                        clients[i] = std::move(clients.back());
+                        clients.pop_back();
+                    }
+                }
+                m_clientCount.store(static_cast<uint32_t>(clients.size()), std::memory_order_relaxed);
+            }
+
+            m_clientCount.store(0, std::memory_order_relaxed);
+        }
+
+        // Fills batch with every report published since the last flush, leaving room at the front for a header
+        uint32_t BuildBatch(BroadcastCursor& cursor, std::vector<uint8_t>& batch, std::vector<uint8_t>& data)
+        {
+            batch.resize(sizeof(StreamFrameHeader));
+            uint32_t count = 0;
+
+            ReportRecord record;
+            while (cursor.Read(m_ring.Ring(), record, data.data(), data.size()))
+            {
+                size_t offset = batch.size();
+                batch.resize(offset + sizeof(record) + record.Length);
+                memcpy(batch.data() + offset, &record, sizeof(record));
+                memcpy(batch.data() + offset + sizeof(record), data.data(), record.Length);
+                count++;
+            }
+
+            return count;
+        }
+
+        void Enqueue(Client& client, std::vector<uint8_t> const& batch, uint32_t count, uint64_t lost)
+        {
+            StreamFrameHeader header;
+            header.Length = static_cast<uint32_t>(batch.size() - sizeof(header));
+            header.RecordCount = count;
+            header.Sequence = client.Sequence++;
+            header.LostReports = static_cast<uint32_t>(lost);
+
+            client.Frames.push_back(batch);
+            memcpy(client.Frames.back().data(), &header, sizeof(header));
+            client.QueuedBytes += batch.size();
+
+            // Drop the oldest whole frames to make room, never the newest or one that's partly sent
+            while (client.QueuedBytes > m_clientBufferSize && client.Frames.size() > 1 &&
+                !(client.Frames.size() == 2 && client.SentOfFront > 0))
+            {
+                auto dropped = client.Frames.begin() + (client.SentOfFront > 0 ? 1 : 0);
+                client.QueuedBytes -= dropped->size();
+                client.Frames.erase(dropped);
+                m_framesDropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        // Sends as much as the socket will take without blocking, returning false if the client has gone
+        bool Flush(Client& client)
+        {
+            while (!client.Frames.empty())
+            {
+                auto& frame = client.Frames.front();
+                int64_t sent = client.Socket.Send(frame.data() + client.SentOfFront, frame.size() - client.SentOfFront);
+                if (sent < 0)
+                    return false;
+                if (sent == 0)
+                    return true;
+
+                client.SentOfFront += static_cast<size_t>(sent);
+                m_bytesSent.fetch_add(static_cast<uint64_t>(sent), std::memory_order_relaxed);
+                if (client.SentOfFront == frame.size())
+                {
+                    client.QueuedBytes -= frame.size();
+                    client.SentOfFront = 0;
+                    client.Frames.pop_front();
+                    m_framesSent.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            return true;
+        }
+    };
+
+    // Receives frames from a StreamServer
+    class StreamClient
+    {
+    private:
+        LocalSocket m_socket;
+        StreamFrameHeader m_header {};
+        std::vector<uint8_t> m_payload;
+
+    public:
+        bool Connect(std::string const& path)
+        {
+            return m_socket.Connect(path);
+        }
+
+        void Close() noexcept
+        {
+            m_socket.Close();
+        }
+
+        // Blocks until the next frame arrives, returning false once the server disconnects
+        bool ReadFrame()
+        {
+            if (!m_socket.ReceiveAll(reinterpret_cast<uint8_t*>(&m_header), sizeof(m_header)))
+                return false;
+
+            m_payload.resize(m_header.Length);
+            return m_socket.ReceiveAll(m_payload.data(), m_payload.size());
+        }
+
+        StreamFrameHeader const& Header() const noexcept { return m_header; }
+        size_t FrameSize() const noexcept { return sizeof(m_header) + m_payload.size(); }
+
+        // Calls func(record, data) for each record in the last frame read
+        template<typename TFunc>
+        void ForEachRecord(TFunc&& func) const
+        {
+            size_t offset = 0;
+            for (uint32_t i = 0; i < m_header.RecordCount && offset + sizeof(ReportRecord) <= m_payload.size(); i++)
+            {
+                ReportRecord record;
+                memcpy(&record, m_payload.data() + offset, sizeof(record));
+                offset += sizeof(record);
+                if (offset + record.Length > m_payload.size())
+                    break;
+
+                func(record, m_payload.data() + offset);
+                offset += record.Length;
+            }
+        }
+    };
+}
@@ -0,0 +1,76 @@
+#include "pch.h"
+#include "WGIC/ReportStreamServer.h"
+#include "WGIC.ReportStreamServer.g.cpp"
+
+namespace winrt::WGIC::implementation
+{
+    std::mutex ReportStreamServer::s_lock;
+    std::atomic<bool> ReportStreamServer::s_running { false };
+    std::unique_ptr<Core::StreamServer> ReportStreamServer::s_server;
+
+    void ReportStreamServer::Start(winrt::hstring const& path, uint32_t flushIntervalMicroseconds, uint32_t clientBufferSize)
+    {
+        auto logger = spdlog::get(s_loggerName)->clone("ReportStreamServer::Start");
+
+        std::lock_guard<std::mutex> lock(s_lock);
+        if (s_server)
+        {
+            logger->error("Already running!");
+            throw winrt::hresult_illegal_method_call();
+        }
+
+        if (path.empty() || flushIntervalMicroseconds == 0 || clientBufferSize == 0)
+        {
+            logger->error("Invalid stream parameters!");
+            throw winrt::hresult_invalid_argument();
+        }
+
+        auto server = std::make_unique<Core::StreamServer>(winrt::to_string(path),
+            std::chrono::microseconds(flushIntervalMicroseconds), clientBufferSize);
+        if (!server->Start())
+        {
+            logger->error("Failed to listen on {}!", winrt::to_string(path));
+            throw winrt::hresult_error(E_FAIL);
+        }
+
+        s_server = std::move(server);
+        s_running.store(true, std::memory_order_relaxed);
+        logger->debug("Streaming reports on {}", winrt::to_string(path));
+    }
+
+    void ReportStreamServer::Stop()
+    {
+        std::unique_ptr<Core::StreamServer> server;
+        {
+            std::lock_guard<std::mutex> lock(s_lock);
+            s_running.store(false, std::memory_order_relaxed);
+            server = std::move(s_server);
+        }
+
+        // Joins the server thread, which is done outside the lock so the sinks aren't held up
+        server.reset();
+    }
+
+    bool ReportStreamServer::IsRunning()
+    {
+        return s_running.load(std::memory_order_relaxed);
+    }
+
+    uint64_t ReportStreamServer::FramesSent()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        return s_server ? s_server->FramesSent() : 0;
+    }
+
+    uint64_t ReportStreamServer::BytesSent()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        return s_server ? s_server->BytesSent() : 0;
+    }
+
+    uint64_t ReportStreamServer::FramesDropped()
+    {
+        std::lock_guard<std::mutex> lock(s_lock);
+        return s_server ? s_server->FramesDropped() : 0;
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.ReportStreamServer.g.h"
+#include "WGIC/ReportStream.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct ReportStreamServer
+    {
+    private:
+        static std::mutex s_lock;
+        static std::atomic<bool> s_running;
+        static std::unique_ptr<Core::StreamServer> s_server;
+
+    public:
+        static void Start(winrt::hstring const& path, uint32_t flushIntervalMicroseconds, uint32_t clientBufferSize);
+        static void Stop();
+
+        static bool IsRunning();
+        static uint64_t FramesSent();
+        static uint64_t BytesSent();
+        static uint64_t FramesDropped();
+
+        // Called for every report, from whichever worker is processing it
+        static void Publish(Core::ReportRecord const& record, winrt::array_view<uint8_t const> data)
+        {
+            if (!s_running.load(std::memory_order_relaxed))
+                return;
+
+            std::lock_guard<std::mutex> lock(s_lock);
+            if (s_server)
+                s_server->Publish(record, data.data(), data.size());
+        }
+    };
+}
+
+namespace winrt::WGIC::factory_implementation
+{
+    struct ReportStreamServer : ReportStreamServerT<ReportStreamServer, implementation::ReportStreamServer>
+    {
+    };
+}
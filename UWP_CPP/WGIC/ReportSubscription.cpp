@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "WGIC/ReportSubscription.h"
+#include "WGIC.ReportSubscription.g.cpp"
+
+namespace winrt::WGIC::implementation
+{
+    ReportSubscription::ReportSubscription(std::shared_ptr<const Core::LocalBroadcastRing> ring, bool fromNow)
+        : m_ring(std::move(ring))
+    {
+        m_cursor.Reset(m_ring->Ring(), fromNow);
+    }
+
+    uint64_t ReportSubscription::Lost()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_cursor.Lost();
+    }
+
+    uint64_t ReportSubscription::Lag()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_cursor.Lag(m_ring->Ring());
+    }
+
+    uint32_t ReportSubscription::MaxReportSize()
+    {
+        return m_ring->Ring().DataSize();
+    }
+
+    bool ReportSubscription::ReadNext(uint64_t& timestamp, uint8_t& messageClass, uint8_t& reportId, uint32_t& length,
+        winrt::array_view<uint8_t> buffer)
+    {
+        Core::ReportRecord record;
+
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (!m_cursor.Read(m_ring->Ring(), record, buffer.data(), buffer.size()))
+        {
+            timestamp = 0;
+            messageClass = 0;
+            reportId = 0;
+            length = 0;
+            return false;
+        }
+
+        timestamp = record.Timestamp;
+        messageClass = record.MessageClass;
+        reportId = record.ReportId;
+        length = record.FullLength;
+        return true;
+    }
+}
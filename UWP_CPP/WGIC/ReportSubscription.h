@@ -0,0 +1,28 @@
+#pragma once
+#include "pch.h"
+#include "WGIC.ReportSubscription.g.h"
+#include "WGIC/BroadcastRing.h"
+
+namespace winrt::WGIC::implementation
+{
+    struct ReportSubscription : ReportSubscriptionT<ReportSubscription>
+    {
+    private:
+        // Keeps the ring alive even if the device goes away first
+        std::shared_ptr<const Core::LocalBroadcastRing> m_ring;
+
+        // Only guards this subscription's cursor, the device's sink never takes it
+        std::mutex m_lock;
+        Core::BroadcastCursor m_cursor;
+
+    public:
+        ReportSubscription(std::shared_ptr<const Core::LocalBroadcastRing> ring, bool fromNow);
+
+        uint64_t Lost();
+        uint64_t Lag();
+        uint32_t MaxReportSize();
+
+        bool ReadNext(uint64_t& timestamp, uint8_t& messageClass, uint8_t& reportId, uint32_t& length,
+            winrt::array_view<uint8_t> buffer);
+    };
+}
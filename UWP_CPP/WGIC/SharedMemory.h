@@ -0,0 +1,183 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace winrt::WGIC::Core
+{
+    // A named region of memory shared between processes: a file mapping on Windows, POSIX shared memory elsewhere.
+    // The process that creates a region owns it, and on POSIX it's unlinked when the owner closes it.
+    // Note that a UWP app's named objects live in its AppContainer namespace, so other processes have to open
+    // them as "AppContainerNamedObjects\<package SID>\<name>".
+    class SharedMemory
+    {
+    private:
+        void* m_data = nullptr;
+        size_t m_size = 0;
+#ifdef _WIN32
+        HANDLE m_mapping = nullptr;
+#else
+        std::string m_name;
+        bool m_owner = false;
+#endif
+
+    public:
+        SharedMemory() = default;
+        SharedMemory(SharedMemory const&) = delete;
+        SharedMemory& operator=(SharedMemory const&) = delete;
+
+        SharedMemory(SharedMemory&& other) noexcept
+        {
+            *this = std::move(other);
+        }
+
+        SharedMemory& operator=(SharedMemory&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Close();
+                std::swap(m_data, other.m_data);
+                std::swap(m_size, other.m_size);
+#ifdef _WIN32
+                std::swap(m_mapping, other.m_mapping);
+#else
+                std::swap(m_name, other.m_name);
+                std::swap(m_owner, other.m_owner);
+#endif
+            }
+
+            return *this;
+        }
+
+        ~SharedMemory()
+        {
+            Close();
+        }
+
+        void* Data() const noexcept { return m_data; }
+        size_t Size() const noexcept { return m_size; }
+        bool IsOpen() const noexcept { return m_data != nullptr; }
+
+        // Creates a zero-filled, writable region
+        bool Create(std::string const& name, size_t size)
+        {
+            Close();
+#ifdef _WIN32
+            std::wstring wideName = Widen(name);
+            m_mapping = CreateFileMappingFromApp(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, size, wideName.c_str());
+            if (!m_mapping || GetLastError() == ERROR_ALREADY_EXISTS)
+            {
+                Close();
+                return false;
+            }
+
+            m_data = MapViewOfFileFromApp(m_mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, size);
+#else
+            std::string path = PosixName(name);
+            int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+            if (fd < 0)
+                return false;
+
+            m_name = path;
+            m_owner = true;
+            if (ftruncate(fd, static_cast<off_t>(size)) == 0)
+            {
+                void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                m_data = data != MAP_FAILED ? data : nullptr;
+            }
+            close(fd);
+#endif
+            if (!m_data)
+            {
+                Close();
+                return false;
+            }
+
+            m_size = size;
+            return true;
+        }
+
+        // Opens an existing region created by another process, read-only
+        bool Open(std::string const& name)
+        {
+            Close();
+#ifdef _WIN32
+            std::wstring wideName = Widen(name);
+            m_mapping = OpenFileMappingFromApp(FILE_MAP_READ, FALSE, wideName.c_str());
+            if (m_mapping)
+                m_data = MapViewOfFileFromApp(m_mapping, FILE_MAP_READ, 0, 0);
+
+            // The view covers the whole mapping, rounded up to a page
+            MEMORY_BASIC_INFORMATION info {};
+            if (m_data && VirtualQuery(m_data, &info, sizeof(info)) != 0)
+                m_size = info.RegionSize;
+#else
+            int fd = shm_open(PosixName(name).c_str(), O_RDONLY, 0);
+            if (fd < 0)
+                return false;
+
+            struct stat info {};
+            if (fstat(fd, &info) == 0 && info.st_size > 0)
+            {
+                void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                m_data = data != MAP_FAILED ? data : nullptr;
+                m_size = static_cast<size_t>(info.st_size);
+            }
+            close(fd);
+#endif
+            if (!m_data)
+            {
+                Close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void Close() noexcept
+        {
+#ifdef _WIN32
+            if (m_data)
+                UnmapViewOfFile(m_data);
+            if (m_mapping)
+                CloseHandle(m_mapping);
+            m_mapping = nullptr;
+#else
+            if (m_data)
+                munmap(m_data, m_size);
+            if (m_owner)
+                shm_unlink(m_name.c_str());
+            m_name.clear();
+            m_owner = false;
+#endif
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+    private:
+#ifdef _WIN32
+        static std::wstring Widen(std::string const& name)
+        {
+            int length = MultiByteToWideChar(CP_UTF8, 0, name.data(), static_cast<int>(name.size()), nullptr, 0);
+            std::wstring wide(static_cast<size_t>(length), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, name.data(), static_cast<int>(name.size()), wide.data(), length);
+            return wide;
+        }
+#else
+        static std::string PosixName(std::string const& name)
+        {
+            return name.empty() || name[0] != '/' ? "/" + name : name;
+        }
+#endif
+    };
+}
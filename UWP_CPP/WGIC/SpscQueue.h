@@ -0,0 +1,141 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // Bounded queue of variable-length entries with one producer thread and one consumer thread, neither of which
+    // ever waits on the other. Entries are stored contiguously in a byte ring, so pushing is a pair of copies.
+    class SpscByteQueue
+    {
+    private:
+        static constexpr uint32_t Padding = UINT32_MAX; // Marks the unused space at the end of the ring before a wrap
+        static constexpr size_t EntryHeaderSize = 8;
+
+        std::vector<uint64_t> m_buffer; // uint64_t so that every entry is 8-byte aligned
+        uint8_t* m_data;
+        size_t m_mask;
+
+        alignas(64) std::atomic<uint64_t> m_write { 0 }; // Bytes ever pushed, including padding
+        uint64_t m_cachedRead = 0;                        // Producer's last view of m_read
+        alignas(64) std::atomic<uint64_t> m_read { 0 };
+        uint64_t m_cachedWrite = 0;                       // Consumer's last view of m_write
+        size_t m_frontSize = 0;
+
+    public:
+        // capacity is rounded up to a power of 2 bytes
+        explicit SpscByteQueue(size_t capacity)
+            : m_buffer(RoundUp(capacity) / sizeof(uint64_t)), m_data(reinterpret_cast<uint8_t*>(m_buffer.data())),
+            m_mask(RoundUp(capacity) - 1)
+        {
+        }
+
+        SpscByteQueue(SpscByteQueue const&) = delete;
+        SpscByteQueue& operator=(SpscByteQueue const&) = delete;
+
+        size_t Capacity() const noexcept { return m_mask + 1; }
+
+        // Producer only. Pushes an entry made of two parts (such as a header and a payload), returning false without
+        // pushing anything if there isn't room.
+        bool Push(const void* first, size_t firstSize, const void* second, size_t secondSize) noexcept
+        {
+            size_t size = firstSize + secondSize;
+            size_t needed = EntryHeaderSize + Align(size);
+            uint64_t write = m_write.load(std::memory_order_relaxed);
+            size_t offset = write & m_mask;
+            size_t untilEnd = Capacity() - offset;
+            size_t total = needed <= untilEnd ? needed : untilEnd + needed;
+
+            if (!HasRoom(write, total))
+                return false;
+
+            if (needed > untilEnd)
+            {
+                memcpy(m_data + offset, &Padding, sizeof(Padding));
+                write += untilEnd;
+                offset = 0;
+            }
+
+            uint32_t header[2] = { static_cast<uint32_t>(size), 0 };
+            memcpy(m_data + offset, header, sizeof(header));
+            memcpy(m_data + offset + EntryHeaderSize, first, firstSize);
+            if (secondSize > 0)
+                memcpy(m_data + offset + EntryHeaderSize + firstSize, second, secondSize);
+
+            // Sequentially consistent so that a consumer which goes idle after this is guaranteed to see it
+            // (see ReportQueue)
+            m_write.store(write + needed, std::memory_order_seq_cst);
+            return true;
+        }
+
+        // Consumer only. Points at the oldest entry without removing it, returning false if the queue is empty.
+        bool Front(const uint8_t*& entry, size_t& size) noexcept
+        {
+            while (true)
+            {
+                uint64_t read = m_read.load(std::memory_order_relaxed);
+                if (read == m_cachedWrite)
+                {
+                    m_cachedWrite = m_write.load(std::memory_order_acquire);
+                    if (read == m_cachedWrite)
+                        return false;
+                }
+
+                size_t offset = read & m_mask;
+                uint32_t header;
+                memcpy(&header, m_data + offset, sizeof(header));
+                if (header == Padding)
+                {
+                    m_read.store(read + (Capacity() - offset), std::memory_order_release);
+                    continue;
+                }
+
+                m_frontSize = header;
+                entry = m_data + offset + EntryHeaderSize;
+                size = header;
+                return true;
+            }
+        }
+
+        // Consumer only. Removes the entry returned by the last successful call to Front.
+        void Pop() noexcept
+        {
+            uint64_t read = m_read.load(std::memory_order_relaxed);
+            m_read.store(read + EntryHeaderSize + Align(m_frontSize), std::memory_order_release);
+        }
+
+        // Safe from any thread, though only exact from the consumer
+        bool Empty() const noexcept
+        {
+            return m_read.load(std::memory_order_acquire) == m_write.load(std::memory_order_seq_cst);
+        }
+
+    private:
+        bool HasRoom(uint64_t write, size_t total) noexcept
+        {
+            if (total > Capacity())
+                return false;
+            if (write + total - m_cachedRead <= Capacity())
+                return true;
+
+            m_cachedRead = m_read.load(std::memory_order_acquire);
+            return write + total - m_cachedRead <= Capacity();
+        }
+
+        static size_t Align(size_t size) noexcept
+        {
+            return (size + 7) & ~static_cast<size_t>(7);
+        }
+
+        static size_t RoundUp(size_t capacity) noexcept
+        {
+            size_t size = 64;
+            while (size < capacity)
+                size <<= 1;
+            return size;
+        }
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "WGIC/TickResampler.h"
+
+namespace winrt::WGIC::Core
+{
+    // A contiguous run of history entries, pointing straight into the history's storage
+    struct HistorySpan
+    {
+        const uint64_t* Timestamps = nullptr;
+        const ControlState* States = nullptr;
+        size_t Count = 0;
+    };
+
+    // Recent control states of a device indexed by report timestamp, for looking up what the state was at a given
+    // time (such as when re-simulating past frames). Entries are kept in a ring with one writer at a time, the worker
+    // processing the device's reports. Readers never lock: they work out which entries are valid from the published
+    // entry count, binary search the timestamps, and check afterwards that the writer didn't overwrite what they read
+    // in the meantime.
+    class StateHistory
+    {
+        static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t), "Spans expose the timestamps as plain values");
+
+    private:
+        std::vector<std::atomic<uint64_t>> m_timestamps;
+        std::vector<ControlState> m_states;
+        size_t m_mask;
+        uint64_t m_retention;
+
+        std::atomic<uint64_t> m_written { 0 }; // Number of entries ever appended
+        std::atomic<uint64_t> m_start { 0 };   // Entries before this are excluded, after the time base went backwards
+
+    public:
+        // capacity is rounded up to a power of 2. Entries older than retention (in timestamp units) relative to the
+        // newest entry are treated as gone, even if they're still in the ring.
+        StateHistory(size_t capacity, uint64_t retention)
+            : m_timestamps(RoundUp(capacity)), m_states(RoundUp(capacity)), m_mask(RoundUp(capacity) - 1),
+            m_retention(retention)
+        {
+        }
+
+        size_t Capacity() const noexcept { return m_mask + 1; }
+        uint64_t Retention() const noexcept { return m_retention; }
+
+        // Must only ever be called by one thread at a time
+        void Append(uint64_t timestamp, ControlState const& state) noexcept
+        {
+            uint64_t written = m_written.load(std::memory_order_relaxed);
+            uint64_t start = m_start.load(std::memory_order_relaxed);
+            if (written > start && timestamp < m_timestamps[(written - 1) & m_mask].load(std::memory_order_relaxed))
+                m_start.store(written, std::memory_order_release);
+
+            // The previous store to m_written already told readers that this slot's entry is no longer safe, as with
+            // an odd sequence in BroadcastRing. The fence keeps the new contents from being seen before that store.
+            std::atomic_thread_fence(std::memory_order_release);
+            size_t slot = written & m_mask;
+            m_timestamps[slot].store(timestamp, std::memory_order_relaxed);
+            m_states[slot] = state;
+            m_written.store(written + 1, std::memory_order_release);
+        }
+
+        // Copies the newest state at or before timestamp. Returns false if there's no such entry in the history.
+        bool StateAt(uint64_t timestamp, uint64_t& entryTimestamp, ControlState& state) const noexcept
+        {
+            while (true)
+            {
+                uint64_t first, end;
+                if (!ValidRange(first, end))
+                    return false;
+
+                uint64_t index = UpperBound(first, end, timestamp);
+                if (index == first)
+                    return false;
+
+                size_t slot = (index - 1) & m_mask;
+                entryTimestamp = m_timestamps[slot].load(std::memory_order_relaxed);
+                state = m_states[slot];
+
+                if (StillValid(index - 1))
+                    return true;
+            }
+        }
+
+        // Finds the entries with timestamps in [from, to], as up to two spans since the range may wrap around the ring.
+        // The spans point into the history itself, so once done with them the caller must check StillValid(token)
+        // and discard what it read if that returns false.
+        size_t Range(uint64_t from, uint64_t to, HistorySpan (&spans)[2], uint64_t& token) const noexcept
+        {
+            spans[0] = {};
+            spans[1] = {};
+            token = 0;
+
+            uint64_t first, end;
+            if (from > to || !ValidRange(first, end))
+                return 0;
+
+            uint64_t begin = LowerBound(first, end, from);
+            uint64_t last = UpperBound(begin, end, to);
+            if (begin >= last)
+                return 0;
+
+            token = begin;
+            size_t count = static_cast<size_t>(last - begin);
+            size_t slot = begin & m_mask;
+            size_t head = count < Capacity() - slot ? count : Capacity() - slot;
+            spans[0] = { reinterpret_cast<const uint64_t*>(&m_timestamps[slot]), &m_states[slot], head };
+            if (head < count)
+                spans[1] = { reinterpret_cast<const uint64_t*>(&m_timestamps[0]), &m_states[0], count - head };
+            return count;
+        }
+
+        // Whether the entry at a logical index (such as a token from Range) still hasn't been overwritten
+        bool StillValid(uint64_t index) const noexcept
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t written = m_written.load(std::memory_order_relaxed);
+            // The slot after the newest entry may be mid-write, so the oldest entry in the ring isn't safe either
+            return written < Capacity() || index > written - Capacity();
+        }
+
+    private:
+        static size_t RoundUp(size_t capacity) noexcept
+        {
+            size_t size = 2;
+            while (size < capacity)
+                size <<= 1;
+            return size;
+        }
+
+        // Logical indices [first, end) of the entries that can be read right now
+        bool ValidRange(uint64_t& first, uint64_t& end) const noexcept
+        {
+            end = m_written.load(std::memory_order_acquire);
+            uint64_t start = m_start.load(std::memory_order_acquire);
+            first = end >= Capacity() ? end - Capacity() + 1 : 0;
+            if (first < start)
+                first = start;
+            if (first >= end)
+                return false;
+
+            // Apply the retention window relative to the newest entry
+            uint64_t newest = m_timestamps[(end - 1) & m_mask].load(std::memory_order_relaxed);
+            if (newest > m_retention)
+                first = LowerBound(first, end, newest - m_retention);
+            return first < end;
+        }
+
+        // First logical index in [first, end) whose timestamp is at or after timestamp
+        uint64_t LowerBound(uint64_t first, uint64_t end, uint64_t timestamp) const noexcept
+        {
+            while (first < end)
+            {
+                uint64_t middle = first + (end - first) / 2;
+                if (m_timestamps[middle & m_mask].load(std::memory_order_relaxed) < timestamp)
+                    first = middle + 1;
+                else
+                    end = middle;
+            }
+
+            return first;
+        }
+
+        // First logical index in [first, end) whose timestamp is after timestamp
+        uint64_t UpperBound(uint64_t first, uint64_t end, uint64_t timestamp) const noexcept
+        {
+            return timestamp == UINT64_MAX ? end : LowerBound(first, end, timestamp + 1);
+        }
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include "WGIC/InputEventMapper.h"
+
+namespace winrt::WGIC::Core
+{
+    constexpr size_t MaxDeviceSlots = 16;
+    constexpr size_t AxesPerDevice = 8;
+    constexpr size_t HatsPerDevice = 4;
+
+    // Decoded state of every device slot, laid out as parallel arrays indexed by slot
+    struct StateSnapshot
+    {
+        uint64_t Generation;
+        uint32_t ActiveSlots; // Bit N is set if slot N is in use
+        uint32_t Claims[MaxDeviceSlots]; // Times each slot was acquired, so state kept per slot elsewhere can be reset
+        uint64_t Timestamps[MaxDeviceSlots];
+        uint64_t Buttons[MaxDeviceSlots];
+        int32_t Axes[MaxDeviceSlots][AxesPerDevice];
+        uint8_t Hats[MaxDeviceSlots][HatsPerDevice];
+    };
+
+    // Shared state table for all devices. Each device claims a slot when created and updates it from its input sink,
+    // and readers take a consistent copy of every slot at once with Snapshot.
+    class StateTable
+    {
+    private:
+        std::mutex m_lock;
+        StateSnapshot m_state {};
+
+    public:
+        // Claims a free slot, returning -1 if all slots are in use
+        int32_t AcquireSlot()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            for (uint32_t slot = 0; slot < MaxDeviceSlots; slot++)
+            {
+                uint32_t bit = 1u << slot;
+                if (m_state.ActiveSlots & bit)
+                    continue;
+
+                m_state.ActiveSlots |= bit;
+                m_state.Claims[slot]++;
+                ClearSlot(slot);
+                m_state.Generation++;
+                return static_cast<int32_t>(slot);
+            }
+
+            return -1;
+        }
+
+        void ReleaseSlot(int32_t slot)
+        {
+            if (slot < 0 || slot >= static_cast<int32_t>(MaxDeviceSlots))
+                return;
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_state.ActiveSlots &= ~(1u << slot);
+            ClearSlot(slot);
+            m_state.Generation++;
+        }
+
+        // Updates a slot from the current control values of a mapper
+        void Update(int32_t slot, uint64_t timestamp, EventMapper const& mapper)
+        {
+            if (slot < 0 || slot >= static_cast<int32_t>(MaxDeviceSlots))
+                return;
+
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_state.Timestamps[slot] = timestamp;
+            mapper.WriteState(m_state.Buttons[slot], m_state.Axes[slot], AxesPerDevice, m_state.Hats[slot], HatsPerDevice);
+            m_state.Generation++;
+        }
+
+        void Snapshot(StateSnapshot& output)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            memcpy(&output, &m_state, sizeof(StateSnapshot));
+        }
+
+    private:
+        void ClearSlot(uint32_t slot) noexcept
+        {
+            m_state.Timestamps[slot] = 0;
+            m_state.Buttons[slot] = 0;
+            memset(m_state.Axes[slot], 0, sizeof(m_state.Axes[slot]));
+            memset(m_state.Hats[slot], 0, sizeof(m_state.Hats[slot]));
+        }
+    };
+}
@@ -0,0 +1,198 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "WGIC/StateTable.h"
+
+namespace winrt::WGIC::Core
+{
+    struct ControlState
+    {
+        uint64_t Buttons;
+        int32_t Axes[AxesPerDevice];
+        uint8_t Hats[HatsPerDevice];
+    };
+
+    struct TickSample
+    {
+        uint64_t Timestamp; // Time of the tick, in the same time base as the reports
+        ControlState State;
+        uint32_t ReportCount; // Number of reports which arrived during the tick
+    };
+
+    // Converts a stream of control states at arbitrary times into one sample per fixed tick.
+    // Axes are either interpolated between the reports on either side of a tick or held from the last report,
+    // and any button that was pressed at some point during a tick is reported as pressed for that tick
+    // so that quick taps between ticks aren't lost.
+    // Time is driven entirely by report timestamps, so replaying the same reports always gives the same ticks.
+    class TickResampler
+    {
+    private:
+        uint64_t m_ticksPerSecond = 0;
+        uint64_t m_timestampsPerSecond = 0;
+        bool m_interpolate = false;
+
+        bool m_started = false;
+        uint64_t m_origin = 0;
+        uint64_t m_tickIndex = 0;
+        uint64_t m_previousTimestamp = 0;
+        ControlState m_previous {};
+        uint64_t m_latchedButtons = 0;
+        uint32_t m_reportCount = 0;
+
+        std::vector<TickSample> m_ticks;
+        size_t m_head = 0;
+        size_t m_count = 0;
+
+    public:
+        TickResampler() = default;
+
+        // timestampsPerSecond is the resolution of report timestamps, which is microseconds for Windows.Gaming.Input
+        TickResampler(uint32_t ticksPerSecond, bool interpolate, size_t capacity,
+            uint64_t timestampsPerSecond = 1000000)
+            : m_ticksPerSecond(ticksPerSecond), m_timestampsPerSecond(timestampsPerSecond),
+            m_interpolate(interpolate), m_ticks(capacity > 0 ? capacity : 1)
+        {
+        }
+
+        bool Enabled() const noexcept { return m_ticksPerSecond != 0; }
+        size_t Size() const noexcept { return m_count; }
+
+        void AddSample(uint64_t timestamp, ControlState const& state)
+        {
+            if (!Enabled())
+                return;
+
+            if (!m_started || timestamp < m_previousTimestamp)
+            {
+                // First report, or the time base went backwards; start the tick grid over
+                m_started = true;
+                m_origin = timestamp;
+                m_tickIndex = 1;
+                m_previousTimestamp = timestamp;
+                m_previous = state;
+                m_latchedButtons = state.Buttons;
+                m_reportCount = 1;
+                return;
+            }
+
+            // Ticks before this report only see the previous report, with axes optionally interpolated towards this one
+            EmitTicksBefore(timestamp, &state);
+
+            // Each tick covers the time after the previous tick, up to and including its own timestamp
+            m_latchedButtons |= state.Buttons;
+            m_reportCount++;
+            m_previousTimestamp = timestamp;
+            m_previous = state;
+
+            if (TickTime(m_tickIndex) == timestamp)
+                EmitTick(timestamp, m_previous);
+        }
+
+        // Emits the ticks up to and including the given time, holding the last report's values.
+        // Used to keep ticks flowing when a device stops sending reports.
+        void AdvanceTo(uint64_t timestamp)
+        {
+            if (!Enabled() || !m_started || timestamp < m_previousTimestamp)
+                return;
+
+            EmitTicksBefore(timestamp, nullptr);
+            if (TickTime(m_tickIndex) == timestamp)
+                EmitTick(timestamp, m_previous);
+        }
+
+        // Removes up to maxCount ticks from the front of the queue, returning how many were written to output
+        size_t Drain(TickSample* output, size_t maxCount) noexcept
+        {
+            size_t count = m_count < maxCount ? m_count : maxCount;
+            for (size_t i = 0; i < count; i++)
+            {
+                output[i] = m_ticks[m_head];
+                m_head = (m_head + 1) % m_ticks.size();
+            }
+
+            m_count -= count;
+            return count;
+        }
+
+    private:
+        uint64_t TickTime(uint64_t index) const noexcept
+        {
+            // Computed from the origin each time so rounding doesn't accumulate, and split into whole seconds so
+            // it doesn't overflow for large indexes
+            uint64_t seconds = index / m_ticksPerSecond;
+            uint64_t remainder = index % m_ticksPerSecond;
+            return m_origin + seconds * m_timestampsPerSecond + remainder * m_timestampsPerSecond / m_ticksPerSecond;
+        }
+
+        // Index of the first tick at or after the given time
+        uint64_t FirstTickAt(uint64_t timestamp) const noexcept
+        {
+            // The smallest index with TickTime(index) >= timestamp, split up the same way
+            uint64_t elapsed = timestamp - m_origin;
+            uint64_t whole = elapsed / m_timestampsPerSecond;
+            uint64_t remainder = elapsed % m_timestampsPerSecond;
+            return whole * m_ticksPerSecond + (remainder * m_ticksPerSecond + m_timestampsPerSecond - 1) / m_timestampsPerSecond;
+        }
+
+        void EmitTicksBefore(uint64_t timestamp, ControlState const* next)
+        {
+            // After a long gap, such as a device that was idle or a timestamp that jumped ahead, only the ticks that
+            // fit in the queue are emitted, as the ones before them would be dropped anyway
+            uint64_t end = FirstTickAt(timestamp);
+            if (end > m_tickIndex + m_ticks.size())
+            {
+                m_tickIndex = end - m_ticks.size();
+                m_latchedButtons = m_previous.Buttons;
+                m_reportCount = 0;
+            }
+
+            for (uint64_t tick = TickTime(m_tickIndex); tick < timestamp; tick = TickTime(m_tickIndex))
+            {
+                ControlState state = m_previous;
+                if (m_interpolate && next)
+                {
+                    int64_t elapsed = static_cast<int64_t>(tick - m_previousTimestamp);
+                    int64_t span = static_cast<int64_t>(timestamp - m_previousTimestamp);
+                    for (size_t axis = 0; axis < AxesPerDevice; axis++)
+                    {
+                        int64_t from = m_previous.Axes[axis];
+                        int64_t to = next->Axes[axis];
+                        state.Axes[axis] = static_cast<int32_t>(from + (to - from) * elapsed / span);
+                    }
+                }
+
+                EmitTick(tick, state);
+            }
+        }
+
+        void EmitTick(uint64_t tick, ControlState const& state)
+        {
+            TickSample sample;
+            sample.Timestamp = tick;
+            sample.State = state;
+            sample.State.Buttons = m_latchedButtons | state.Buttons;
+            sample.ReportCount = m_reportCount;
+            Push(sample);
+
+            // Buttons still held carry over into the next tick
+            m_latchedButtons = m_previous.Buttons;
+            m_reportCount = 0;
+            m_tickIndex++;
+        }
+
+        void Push(TickSample const& sample) noexcept
+        {
+            if (m_count < m_ticks.size())
+            {
+                m_ticks[(m_head + m_count) % m_ticks.size()] = sample;
+                m_count++;
+            }
+            else
+            {
+                // Drop the oldest tick
+                m_ticks[m_head] = sample;
+                m_head = (m_head + 1) % m_ticks.size();
+            }
+        }
+    };
+}
@@ -0,0 +1,158 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace winrt::WGIC::Core
+{
+    // A fixed set of threads running tasks. Each thread has its own queue, and a thread whose queue is empty
+    // takes work from the back of another's, so one busy device can't leave the other threads idle.
+    class WorkerPool
+    {
+    public:
+        class Task
+        {
+        public:
+            virtual ~Task() = default;
+            virtual void Run() = 0;
+        };
+
+    private:
+        struct Worker
+        {
+            std::mutex Lock;
+            std::deque<std::shared_ptr<Task>> Tasks;
+        };
+
+        static inline thread_local WorkerPool* t_pool = nullptr;
+        static inline thread_local size_t t_index = 0;
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<size_t> m_nextWorker { 0 };
+
+        std::atomic<size_t> m_queued { 0 };
+        std::atomic<size_t> m_sleeping { 0 };
+        std::mutex m_sleepLock;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+
+    public:
+        explicit WorkerPool(size_t threadCount)
+        {
+            threadCount = std::max<size_t>(threadCount, 1);
+            for (size_t i = 0; i < threadCount; i++)
+                m_workers.push_back(std::make_unique<Worker>());
+            for (size_t i = 0; i < threadCount; i++)
+                m_threads.emplace_back(&WorkerPool::Run, this, i);
+        }
+
+        WorkerPool(WorkerPool const&) = delete;
+        WorkerPool& operator=(WorkerPool const&) = delete;
+
+        // Queued tasks which haven't started yet are dropped
+        ~WorkerPool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sleepLock);
+                m_stopping = true;
+            }
+            m_wake.notify_all();
+
+            for (auto& thread : m_threads)
+                thread.join();
+        }
+
+        size_t ThreadCount() const noexcept { return m_threads.size(); }
+
+        // Queues a task, on the calling thread's own queue if it's one of the pool's threads
+        void Submit(std::shared_ptr<Task> task)
+        {
+            size_t index = t_pool == this ? t_index : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+            {
+                std::lock_guard<std::mutex> lock(m_workers[index]->Lock);
+                m_workers[index]->Tasks.push_back(std::move(task));
+            }
+
+            // Pairs with the sleeping thread incrementing m_sleeping before checking m_queued
+            m_queued.fetch_add(1, std::memory_order_seq_cst);
+            if (m_sleeping.load(std::memory_order_seq_cst) > 0)
+            {
+                std::lock_guard<std::mutex> lock(m_sleepLock);
+                m_wake.notify_one();
+            }
+        }
+
+    private:
+        void Run(size_t index)
+        {
+            t_pool = this;
+            t_index = index;
+
+            while (true)
+            {
+                std::shared_ptr<Task> task = Take(index);
+                if (!task)
+                {
+                    // Briefly keep looking before sleeping, since waking a thread costs far more than a short spin
+                    for (int spin = 0; spin < 64 && !task; spin++)
+                    {
+                        std::this_thread::yield();
+                        task = Take(index);
+                    }
+                }
+
+                if (task)
+                {
+                    task->Run();
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(m_sleepLock);
+                m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+                m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_seq_cst) > 0; });
+                m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+                if (m_stopping)
+                    return;
+            }
+        }
+
+        // Takes the oldest task from this thread's queue, or the newest from another thread's
+        std::shared_ptr<Task> Take(size_t index)
+        {
+            if (m_queued.load(std::memory_order_relaxed) == 0)
+                return nullptr;
+
+            for (size_t i = 0; i < m_workers.size(); i++)
+            {
+                Worker& worker = *m_workers[(index + i) % m_workers.size()];
+                std::lock_guard<std::mutex> lock(worker.Lock);
+                if (worker.Tasks.empty())
+                    continue;
+
+                std::shared_ptr<Task> task;
+                if (i == 0)
+                {
+                    task = std::move(worker.Tasks.front());
+                    worker.Tasks.pop_front();
+                }
+                else
+                {
+                    task = std::move(worker.Tasks.back());
+                    worker.Tasks.pop_back();
+                }
+
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+
+            return nullptr;
+        }
+    };
+}
@@ -29,6 +29,26 @@ namespace winrt::WGIC::implementation
         }
     }
 
+    uint32_t XusbDevice::CopyLatestInput(uint64_t& timestamp, uint8_t& reportId, winrt::array_view<uint8_t> reportBuffer,
+        WGIC::ReportChange& change)
+    {
+        std::lock_guard<std::mutex> lock(m_readingLock);
+        if (m_inputSuspended)
+        {
+            timestamp = 0;
+            reportId = 0;
+            change = {};
+            return 0;
+        }
+
+        timestamp = m_currentTimestamp;
+        reportId = m_currentReportId;
+        change = m_currentChange;
+        uint32_t size = m_currentReport.size();
+        memcpy(reportBuffer.data(), m_currentReport.data(), std::min(size, reportBuffer.size()));
+        return size;
+    }
+
     void XusbDevice::SetVibration(double lowFrequencyMotorSpeed, double highFrequencyMotorSpeed)
     {
         m_provider.SetVibration(lowFrequencyMotorSpeed, highFrequencyMotorSpeed);
@@ -45,10 +65,19 @@ namespace winrt::WGIC::implementation
 #endif
 
         std::lock_guard<std::mutex> lock(m_readingLock);
+        uint64_t changeMask = reportId != m_currentReportId ? ~0ull
+            : Core::ReportChangeMask(m_currentReport.data(), m_currentReport.size(), inputBuffer.data(), inputBuffer.size());
+
+        // The report is dropped if there's no buffer for it
+        uint32_t size = inputBuffer.size();
+        if (!ResizeBuffer(m_currentReport, size))
+            return;
+
+        m_currentChange = { changeMask, changeMask == 0 };
+        QueueReport(timestamp, reportId, inputBuffer, changeMask);
+
         m_currentTimestamp = timestamp;
         m_currentReportId = reportId;
-        int size = inputBuffer.size();
-        m_currentReport = winrt::com_array<uint8_t>(size);
         memcpy(m_currentReport.data(), inputBuffer.data(), size);
     }
 }
\ No newline at end of file
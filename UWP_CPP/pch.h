@@ -1,5 +1,7 @@
 ﻿#pragma once
 
+// Must come before windows.h, which would otherwise pull in the older winsock.h
+#include <winsock2.h>
 #include <windows.h>
 #include <unknwn.h>
 #include <restrictederrorinfo.h>
@@ -10,6 +12,7 @@
 #include <winrt/Windows.ApplicationModel.Activation.h>
 #include <winrt/Windows.Gaming.Input.h>
 #include <winrt/Windows.Gaming.Input.Custom.h>
+#include <winrt/Windows.Storage.h>
 #include <winrt/Windows.System.h>
 #include <winrt/Windows.UI.h>
 #include <winrt/Windows.UI.Core.h>
@@ -38,9 +41,12 @@ namespace Custom = winrt::Windows::Gaming::Input::Custom;
 namespace TestApp = winrt::UWP_CPP;
 namespace WGIC = winrt::WGIC;
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <fmt/core.h>